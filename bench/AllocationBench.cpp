@@ -0,0 +1,115 @@
+// Counts allocator traffic per snapshot update: the std::map book that used to
+// rebuild every level versus OrderBook drawing from its own arena, and the
+// feed's full path of updating the book and publishing a SnapshotSlot.
+#include "BenchUtil.h"
+#include "trading/BookSnapshot.h"
+#include "trading/OrderBook.h"
+
+#include <cstdlib>
+#include <deque>
+#include <map>
+#include <new>
+#include <vector>
+
+namespace {
+
+size_t globalAllocations = 0;
+
+class MapOrderBook {
+public:
+    void setOrderBook(const std::vector<Order>& newBids, const std::vector<Order>& newAsks) {
+        bids.clear();
+        asks.clear();
+        for (const auto& bid : newBids) bids[bid.price].push_back(bid);
+        for (const auto& ask : newAsks) asks[ask.price].push_back(ask);
+    }
+
+private:
+    std::map<Price, std::deque<Order>> bids;
+    std::map<Price, std::deque<Order>> asks;
+};
+
+template <typename Book>
+size_t countGlobalAllocations(Book& book, const std::vector<Snapshot>& snapshots) {
+    size_t before = globalAllocations;
+    for (const auto& snapshot : snapshots) {
+        book.setOrderBook(snapshot.bids, snapshot.asks);
+    }
+    return globalAllocations - before;
+}
+
+// As the feed does it: update the book, then publish it while a reader
+// still holds the snapshot before
+struct PublishedBook {
+    OrderBook book{BookMode::L2};
+    SnapshotSlot slot;
+    std::shared_ptr<const BookSnapshot> held;
+
+    void setOrderBook(const std::vector<Order>& bids, const std::vector<Order>& asks) {
+        held = slot.load();
+        book.setOrderBook(bids, asks);
+        slot.publish(book);
+    }
+};
+
+void report(const std::string& name, size_t allocations, size_t updates) {
+    std::cout << "  " << std::left << std::setw(40) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(10) << static_cast<double>(allocations) / static_cast<double>(updates) << " allocs/update\n";
+}
+
+} // namespace
+
+void* operator new(std::size_t bytes) {
+    ++globalAllocations;
+    if (void* p = std::malloc(bytes)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+int main() {
+    const int depth = 20;
+    // Gaps of up to 200 ticks, so the far levels spill past the ladder window.
+    // Warmed on the same updates, so every book has already held its deepest overflow.
+    auto snapshots = makeSnapshots(20000, depth, 200);
+
+    MapOrderBook mapBook;
+    OrderBook l3Book(BookMode::L3);
+    OrderBook l2Book(BookMode::L2);
+    countGlobalAllocations(mapBook, snapshots);
+    countGlobalAllocations(l3Book, snapshots);
+    countGlobalAllocations(l2Book, snapshots);
+    PublishedBook published;
+    countGlobalAllocations(published, snapshots);
+    BookStats warmL3 = l3Book.stats();
+    BookStats warmL2 = l2Book.stats();
+
+    std::cout << "Global heap allocations per snapshot update (" << depth << " levels a side, warm)\n";
+    report("std::map<Price, std::deque<Order>>", countGlobalAllocations(mapBook, snapshots), snapshots.size());
+    report("OrderBook L3", countGlobalAllocations(l3Book, snapshots), snapshots.size());
+    report("OrderBook L2", countGlobalAllocations(l2Book, snapshots), snapshots.size());
+    report("OrderBook L2 + SnapshotSlot::publish", countGlobalAllocations(published, snapshots), snapshots.size());
+
+    std::cout << "\nBook stats after " << 2 * snapshots.size() << " updates\n";
+    // Container traffic is counted over the warm updates only, as the global counts are
+    for (const auto& [book, warm] : {std::make_pair(&l3Book, warmL3), std::make_pair(&l2Book, warmL2)}) {
+        BookStats stats = book->stats();
+        double updates = static_cast<double>(snapshots.size());
+        std::cout << "  " << (book->getMode() == BookMode::L2 ? "L2" : "L3")
+                  << " levels=" << stats.bidLevels << "/" << stats.askLevels
+                  << " max=" << stats.maxBidLevels << "/" << stats.maxAskLevels
+                  << " | container allocs/update=" << std::setprecision(3)
+                  << (stats.memory.allocations - warm.memory.allocations) / updates
+                  << " frees/update=" << (stats.memory.deallocations - warm.memory.deallocations) / updates
+                  << " in use=" << stats.memory.bytesInUse << "B"
+                  << " | heap allocs=" << stats.memory.heapAllocations << " frees=" << stats.memory.heapDeallocations
+                  << " held=" << stats.memory.heapBytes << "B\n";
+    }
+    return 0;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "trading/Order.h"
+
+// Keeps the compiler from optimising away a benchmarked result
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Runs fn(i) for i in [0, iterations) and returns the mean nanoseconds per call
+template <typename Fn>
+double measureNsPerOp(size_t iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        fn(i);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+}
+
+// Both sides of one feed message, best price first
+struct Snapshot {
+    std::vector<Order> bids;
+    std::vector<Order> asks;
+};
+
+// Seeded random walk of BTC-like snapshots: depth levels a side around a mid
+// that drifts up to 3 ticks per message, each level 1 to maxGap ticks behind
+// the one before it
+inline std::vector<Snapshot> makeSnapshots(size_t count, size_t depth, int maxGap = 4) {
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<int> step(-3, 3);
+    std::uniform_int_distribution<int> gap(1, maxGap);
+    std::uniform_int_distribution<Quantity> size(100000, 250000000);
+
+    std::vector<Snapshot> snapshots(count);
+    Price mid = 6500000;
+    for (auto& snapshot : snapshots) {
+        mid += step(rng);
+        Price bid = mid - 1;
+        Price ask = mid + 1;
+        for (size_t level = 0; level < depth; ++level) {
+            snapshot.bids.emplace_back(bid, size(rng));
+            snapshot.asks.emplace_back(ask, size(rng));
+            bid -= gap(rng);
+            ask += gap(rng);
+        }
+    }
+    return snapshots;
+}
+
+inline void printResult(const std::string& name, double nsPerOp) {
+    std::cout << "  " << std::left << std::setw(48) << name
+              << std::right << std::fixed << std::setprecision(1) << std::setw(10) << nsPerOp << " ns/op\n";
+}
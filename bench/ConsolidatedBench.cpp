@@ -0,0 +1,110 @@
+// Keeping a consolidated view of four venues current at feed rate: a k-way
+// heap merge of every venue's levels after each update, against updating
+// ConsolidatedBook in place from a venue delta or a venue book resync.
+#include "BenchUtil.h"
+#include "trading/ConsolidatedBook.h"
+#include "trading/OrderBook.h"
+
+#include <array>
+#include <queue>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr int VENUES = 4;
+constexpr int DEPTH = 20;
+constexpr size_t TOP = 10;
+
+struct Update {
+    int venue;
+    Price price;
+    Quantity volume;
+};
+
+// Each venue quotes the same ladder of prices with gaps, so venues overlap on some levels
+std::vector<Update> makeUpdates(size_t count, std::vector<OrderBook>& venues) {
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<Quantity> size(100000, 250000000);
+    for (int venue = 0; venue < VENUES; ++venue) {
+        for (int level = 0; level < DEPTH; ++level) {
+            venues[venue].applyUpdate(Side::Bid, 6499999 - level * 2 - venue % 2, size(rng));
+        }
+    }
+
+    std::vector<Update> updates;
+    for (size_t i = 0; i < count; ++i) {
+        int venue = static_cast<int>(rng() % VENUES);
+        updates.push_back({venue, 6499999 - static_cast<Price>(rng() % DEPTH) * 2 - venue % 2, size(rng)});
+    }
+    return updates;
+}
+
+// Merges the venues' best-first bids with a heap, summing equal prices, up to TOP levels
+size_t remergeBids(const std::vector<OrderBook>& venues, std::array<std::vector<BookLevel>, VENUES>& levels,
+                   BookLevel* out) {
+    using Head = std::pair<Price, int>; // price, venue
+    std::priority_queue<Head> heads;
+    std::array<size_t, VENUES> next{};
+    for (int venue = 0; venue < VENUES; ++venue) {
+        levels[venue].resize(venues[venue].levelCount(Side::Bid));
+        levels[venue].resize(venues[venue].topBids(levels[venue].size(), levels[venue].data()));
+        if (!levels[venue].empty()) heads.push({levels[venue][0].price, venue});
+    }
+
+    size_t written = 0;
+    while (!heads.empty()) {
+        auto [price, venue] = heads.top();
+        heads.pop();
+        if (written > 0 && out[written - 1].price == price) {
+            out[written - 1].volume += levels[venue][next[venue]].volume;
+        } else if (written == TOP) {
+            break;
+        } else {
+            out[written++] = {price, levels[venue][next[venue]].volume, 1};
+        }
+        if (++next[venue] < levels[venue].size()) heads.push({levels[venue][next[venue]].price, venue});
+    }
+    return written;
+}
+
+} // namespace
+
+int main() {
+    const size_t iterations = 400000;
+    std::vector<OrderBook> venues(VENUES, OrderBook(BookMode::L2));
+    auto updates = makeUpdates(4096, venues);
+
+    ConsolidatedBook consolidated;
+    for (int venue = 0; venue < VENUES; ++venue) {
+        consolidated.addVenue("venue" + std::to_string(venue));
+        consolidated.syncVenue(static_cast<VenueId>(venue), venues[venue]);
+    }
+
+    std::cout << VENUES << " venues x " << DEPTH << " bid levels; each update reads NBBO and the top " << TOP
+              << " consolidated levels\n";
+
+    std::array<std::vector<BookLevel>, VENUES> scratch;
+    std::array<BookLevel, TOP> merged;
+    printResult("venue update + k-way re-merge", measureNsPerOp(iterations, [&](size_t i) {
+        const Update& update = updates[i % updates.size()];
+        venues[update.venue].applyUpdate(Side::Bid, update.price, update.volume);
+        doNotOptimize(remergeBids(venues, scratch, merged.data()));
+    }));
+
+    std::array<ConsolidatedLevel, TOP> top;
+    printResult("ConsolidatedBook applyUpdate", measureNsPerOp(iterations, [&](size_t i) {
+        const Update& update = updates[i % updates.size()];
+        consolidated.applyUpdate(static_cast<VenueId>(update.venue), Side::Bid, update.price, update.volume);
+        doNotOptimize(consolidated.nbbo());
+        doNotOptimize(consolidated.topBids(TOP, top.data()));
+    }));
+    printResult("venue update + ConsolidatedBook syncVenue", measureNsPerOp(iterations, [&](size_t i) {
+        const Update& update = updates[i % updates.size()];
+        venues[update.venue].applyUpdate(Side::Bid, update.price, update.volume);
+        consolidated.syncVenue(static_cast<VenueId>(update.venue), venues[update.venue]);
+        doNotOptimize(consolidated.nbbo());
+        doNotOptimize(consolidated.topBids(TOP, top.data()));
+    }));
+    return 0;
+}
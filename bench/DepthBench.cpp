@@ -0,0 +1,188 @@
+// Depth queries asked on every tick: cumulative depth, price for a size,
+// volume within N bps of mid and cost to fill, against the same scalar loops
+// over std::map; and the microstructure signals against recomputing them
+// from getBids()/getAsks().
+#include "BenchUtil.h"
+#include "trading/DepthKernels.h"
+#include "trading/OrderBook.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Book {
+    std::vector<Order> bids;
+    std::vector<Order> asks;
+};
+
+Book makeBook(int depth) {
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<int> gap(1, 4);
+    std::uniform_int_distribution<Quantity> size(100000, 250000000);
+
+    Book book;
+    Price bid = 6499999;
+    Price ask = 6500001;
+    for (int level = 0; level < depth; ++level) {
+        book.bids.emplace_back(bid, size(rng));
+        book.asks.emplace_back(ask, size(rng));
+        bid -= gap(rng);
+        ask += gap(rng);
+    }
+    return book;
+}
+
+// The scalar versions a caller would write over a map-backed side
+Quantity mapCumulativeDepth(const std::map<Price, Quantity, std::greater<Price>>& side, size_t n, Quantity* out) {
+    size_t i = 0;
+    Quantity total = 0;
+    for (auto it = side.begin(); it != side.end() && i < n; ++it, ++i) {
+        total += it->second;
+        out[i] = total;
+    }
+    return total;
+}
+
+Price mapPriceForSize(const std::map<Price, Quantity, std::greater<Price>>& side, Quantity size) {
+    Quantity total = 0;
+    for (const auto& [price, volume] : side) {
+        total += volume;
+        if (total >= size) return price;
+    }
+    return -1;
+}
+
+Quantity mapDepthWithin(const std::map<Price, Quantity, std::greater<Price>>& side, Price limit) {
+    Quantity total = 0;
+    for (auto it = side.begin(); it != side.end() && it->first >= limit; ++it) {
+        total += it->second;
+    }
+    return total;
+}
+
+double mapCostToFill(const std::map<Price, Quantity, std::greater<Price>>& side, Quantity size) {
+    double cost = 0;
+    for (const auto& [price, volume] : side) {
+        Quantity taken = std::min(size, volume);
+        cost += static_cast<double>(price) * static_cast<double>(taken);
+        size -= taken;
+        if (size == 0) return cost;
+    }
+    return -1;
+}
+
+// The five signals the way callers used to compute them, from copied level vectors
+double vectorSignals(const OrderBook& book, size_t levels) {
+    std::vector<Order> bids = book.getBids();
+    std::vector<Order> asks = book.getAsks();
+    double bestBid = static_cast<double>(bids[0].price);
+    double bestAsk = static_cast<double>(asks[0].price);
+    double mid = (bestBid + bestAsk) / 2.0;
+    double micro = (bestBid * asks[0].volume + bestAsk * bids[0].volume) / static_cast<double>(bids[0].volume + asks[0].volume);
+    double spreadBps = (bestAsk - bestBid) / mid * 10000.0;
+
+    double bidVolume = 0, bidNotional = 0, askVolume = 0, askNotional = 0;
+    for (size_t i = 0; i < levels && i < bids.size(); ++i) {
+        bidVolume += bids[i].volume;
+        bidNotional += static_cast<double>(bids[i].price) * bids[i].volume;
+    }
+    for (size_t i = 0; i < levels && i < asks.size(); ++i) {
+        askVolume += asks[i].volume;
+        askNotional += static_cast<double>(asks[i].price) * asks[i].volume;
+    }
+    double weightedMid = (bidNotional / bidVolume * askVolume + askNotional / askVolume * bidVolume) / (bidVolume + askVolume);
+    double imbalance = (bidVolume - askVolume) / (bidVolume + askVolume);
+    return mid + micro + spreadBps + weightedMid + imbalance;
+}
+
+double bookSignals(const OrderBook& book, size_t levels) {
+    return book.mid() + book.microprice() + book.spreadBps() + book.weightedMid(levels) + book.imbalance(levels);
+}
+
+} // namespace
+
+int main() {
+    const size_t iterations = 1000000;
+    const double bps = 10.0;
+
+    std::cout << "Depth kernels: " << (depthKernelsUseAvx2() ? "AVX2" : "scalar") << "\n";
+    for (int depth : {50, 500}) {
+        Book snapshot = makeBook(depth);
+        std::map<Price, Quantity, std::greater<Price>> mapBids;
+        Quantity half = 0;
+        for (const auto& bid : snapshot.bids) {
+            mapBids[bid.price] = bid.volume;
+            half += bid.volume;
+        }
+        half /= 2;
+
+        OrderBook book(BookMode::L2);
+        book.setOrderBook(snapshot.bids, snapshot.asks);
+        double mid = (book.bestBid() + book.bestAsk()) / 2.0;
+        Price limit = static_cast<Price>(std::ceil(mid - mid * bps / 10000.0));
+        std::vector<Quantity> out(depth);
+
+        std::string suffix = " (" + std::to_string(depth) + " levels)";
+        std::cout << "\nBids" << suffix << "\n";
+
+        printResult("std::map cumulative depth", measureNsPerOp(iterations, [&](size_t) {
+            doNotOptimize(mapCumulativeDepth(mapBids, out.size(), out.data()));
+        }));
+        printResult("OrderBook cumulativeDepth", measureNsPerOp(iterations, [&](size_t) {
+            doNotOptimize(book.cumulativeDepth(Side::Bid, out.size(), out.data()));
+            doNotOptimize(out.back());
+        }));
+
+        printResult("std::map price for half the side", measureNsPerOp(iterations, [&](size_t) {
+            doNotOptimize(mapPriceForSize(mapBids, half));
+        }));
+        printResult("OrderBook priceForSize", measureNsPerOp(iterations, [&](size_t) {
+            doNotOptimize(book.priceForSize(Side::Bid, half));
+        }));
+
+        printResult("std::map depth within 10 bps", measureNsPerOp(iterations, [&](size_t) {
+            doNotOptimize(mapDepthWithin(mapBids, limit));
+        }));
+        printResult("OrderBook depthWithinBps", measureNsPerOp(iterations, [&](size_t) {
+            doNotOptimize(book.depthWithinBps(Side::Bid, bps));
+        }));
+
+        // Slippage for 32 candidate sizes up to the whole side
+        const int candidates = 32;
+        Quantity step = half * 2 / candidates;
+        printResult("std::map cost to fill, 32 sizes", measureNsPerOp(iterations / 16, [&](size_t) {
+            for (int c = 1; c <= candidates; ++c) doNotOptimize(mapCostToFill(mapBids, step * c));
+        }));
+        printResult("OrderBook costToFill, 32 sizes", measureNsPerOp(iterations / 16, [&](size_t) {
+            for (int c = 1; c <= candidates; ++c) doNotOptimize(book.costToFill(Side::Bid, step * c));
+        }));
+        printResult("OrderBook update + costToFill, 32 sizes", measureNsPerOp(iterations / 16, [&](size_t i) {
+            book.applyUpdate(Side::Bid, snapshot.bids[depth / 2].price, snapshot.bids[depth / 2].volume + (i & 1));
+            for (int c = 1; c <= candidates; ++c) doNotOptimize(book.costToFill(Side::Bid, step * c));
+        }));
+
+        // A feed update between queries forces the columns to be rebuilt
+        Quantity touch = snapshot.bids[0].volume;
+        printResult("OrderBook update + all three queries", measureNsPerOp(iterations / 4, [&](size_t i) {
+            book.applyUpdate(Side::Bid, snapshot.bids[0].price, touch + static_cast<Quantity>(i & 1));
+            doNotOptimize(book.cumulativeDepth(Side::Bid, out.size(), out.data()));
+            doNotOptimize(book.priceForSize(Side::Bid, half));
+            doNotOptimize(book.depthWithinBps(Side::Bid, bps));
+        }));
+
+        // mid, microprice, spreadBps, and weightedMid/imbalance over 10 levels after every update
+        printResult("update + signals from getBids/getAsks", measureNsPerOp(iterations / 16, [&](size_t i) {
+            book.applyUpdate(Side::Bid, snapshot.bids[2].price, snapshot.bids[2].volume + static_cast<Quantity>(i & 1));
+            doNotOptimize(vectorSignals(book, 10));
+        }));
+        printResult("update + OrderBook signals", measureNsPerOp(iterations / 4, [&](size_t i) {
+            book.applyUpdate(Side::Bid, snapshot.bids[2].price, snapshot.bids[2].volume + static_cast<Quantity>(i & 1));
+            doNotOptimize(bookSignals(book, 10));
+        }));
+    }
+    return 0;
+}
@@ -0,0 +1,86 @@
+// Cost and size of sending only what changed: diffing a 10-level book
+// against each incoming snapshot, or two published snapshots against each
+// other, versus copying out every level for a full payload.
+#include "BenchUtil.h"
+#include "trading/BookDiff.h"
+#include "trading/BookSnapshot.h"
+#include "trading/OrderBook.h"
+
+#include <random>
+#include <vector>
+
+namespace {
+
+// A feed where each message moves the size of one or two levels and, now
+// and then, shifts the best price by a tick
+std::vector<Snapshot> makeFeed(size_t count, int depth) {
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<Quantity> size(100000, 250000000);
+
+    Snapshot book;
+    for (int level = 0; level < depth; ++level) {
+        book.bids.emplace_back(6499999 - level, size(rng));
+        book.asks.emplace_back(6500001 + level, size(rng));
+    }
+
+    std::vector<Snapshot> feed;
+    feed.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        for (int changes = 1 + static_cast<int>(rng() % 2); changes > 0; --changes) {
+            auto& side = rng() % 2 ? book.bids : book.asks;
+            side[rng() % side.size()].volume = size(rng);
+        }
+        if (rng() % 16 == 0) {
+            Price shift = rng() % 2 ? 1 : -1;
+            for (auto& bid : book.bids) bid.price += shift;
+            for (auto& ask : book.asks) ask.price += shift;
+        }
+        feed.push_back(book);
+    }
+    return feed;
+}
+
+} // namespace
+
+int main() {
+    const int depth = 10;
+    auto feed = makeFeed(4096, depth);
+    const size_t iterations = feed.size() * 64;
+
+    OrderBook book(BookMode::L2);
+    BookDiff diff;
+    size_t deltas = 0;
+    for (const auto& message : feed) {
+        deltas += diff.diff(book, message.bids, message.asks);
+        book.setOrderBook(message.bids, message.asks);
+    }
+    std::cout << "Levels per full payload: " << 2 * depth
+              << ", mean deltas per message: " << static_cast<double>(deltas) / static_cast<double>(feed.size()) << "\n\n";
+
+    std::vector<std::shared_ptr<const BookSnapshot>> published;
+    for (const auto& message : feed) {
+        book.setOrderBook(message.bids, message.asks);
+        published.push_back(std::make_shared<const BookSnapshot>(book, published.size() + 1));
+    }
+
+    printResult("full payload (BookSnapshot of every level)", measureNsPerOp(iterations, [&](size_t i) {
+        BookSnapshot full(book, i);
+        doNotOptimize(full.getBids().data());
+    }));
+    printResult("setOrderBook per message", measureNsPerOp(iterations, [&](size_t i) {
+        const auto& message = feed[i % feed.size()];
+        book.setOrderBook(message.bids, message.asks);
+        doNotOptimize(book.bestBid());
+    }));
+    printResult("BookDiff between published snapshots", measureNsPerOp(iterations, [&](size_t i) {
+        size_t at = 1 + i % (published.size() - 1);
+        doNotOptimize(diff.diff(*published[at - 1], *published[at]));
+    }));
+    printResult("setOrderBook + BookDiff per message", measureNsPerOp(iterations, [&](size_t i) {
+        const auto& message = feed[i % feed.size()];
+        diff.diff(book, message.bids, message.asks);
+        book.setOrderBook(message.bids, message.asks);
+        doNotOptimize(diff.deltas().data());
+    }));
+    return 0;
+}
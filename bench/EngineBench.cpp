@@ -0,0 +1,80 @@
+// Throughput and per-order latency of OrderBook::submit on a synthetic order
+// flow mixing limit, market, IOC, FOK and post-only orders around a moving mid.
+#include "BenchUtil.h"
+#include "trading/OrderBook.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+std::vector<OrderRequest> makeFlow(size_t count) {
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<int> typeRoll(0, 99);
+    std::uniform_int_distribution<int> offset(-20, 20);
+    std::uniform_int_distribution<Quantity> size(1, 20);
+
+    std::vector<OrderRequest> flow;
+    flow.reserve(count);
+    Price mid = 100000;
+    for (size_t i = 0; i < count; ++i) {
+        if (i % 64 == 0) mid += offset(rng) / 10;
+        Side side = (rng() & 1) ? Side::Bid : Side::Ask;
+        int roll = typeRoll(rng);
+        OrderType type = roll < 55 ? OrderType::Limit
+                       : roll < 75 ? OrderType::ImmediateOrCancel
+                       : roll < 85 ? OrderType::Market
+                       : roll < 90 ? OrderType::FillOrKill
+                       : OrderType::PostOnly;
+        flow.push_back({side, type, mid + offset(rng), size(rng)});
+    }
+    return flow;
+}
+
+double percentile(std::vector<double>& samples, double p) {
+    size_t index = static_cast<size_t>(p * static_cast<double>(samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+} // namespace
+
+int main() {
+    const size_t orders = 1000000;
+    auto flow = makeFlow(orders);
+    FillSink sink;
+    sink.reserve(1024);
+
+    for (BookMode mode : {BookMode::L3, BookMode::L2}) {
+        std::cout << (mode == BookMode::L2 ? "L2 book\n" : "L3 book\n");
+
+        OrderBook book(mode);
+        size_t fills = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& request : flow) {
+            sink.clear();
+            book.submit(request, sink);
+            fills += sink.size();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "  throughput  " << std::fixed << std::setprecision(2) << orders / seconds / 1e6 << " M orders/s, "
+                  << fills / seconds / 1e6 << " M fills/s\n";
+
+        OrderBook timedBook(mode);
+        std::vector<double> latencies;
+        latencies.reserve(orders);
+        for (const auto& request : flow) {
+            sink.clear();
+            auto begin = std::chrono::steady_clock::now();
+            timedBook.submit(request, sink);
+            latencies.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count());
+        }
+        std::cout << "  latency ns  p50=" << std::setprecision(0) << percentile(latencies, 0.50)
+                  << " p99=" << percentile(latencies, 0.99)
+                  << " p99.9=" << percentile(latencies, 0.999)
+                  << " max=" << *std::max_element(latencies.begin(), latencies.end()) << "\n";
+        std::cout << "  resting     " << book.getBids().size() << " bids, " << book.getAsks().size() << " asks\n\n";
+    }
+    return 0;
+}
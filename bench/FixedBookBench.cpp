@@ -0,0 +1,72 @@
+// Compares the inline fixed-depth book with the ladder-backed OrderBook for
+// the top-N feed: snapshots, level updates and top-of-book reads.
+#include "BenchUtil.h"
+#include "trading/FixedDepthBook.h"
+#include "trading/Instrument.h"
+#include "trading/OrderBook.h"
+
+#include <random>
+#include <vector>
+
+namespace {
+
+std::vector<LevelUpdate> makeUpdates(size_t count) {
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<int> offset(1, 40);
+    std::uniform_int_distribution<Quantity> size(0, 250000000);
+    std::vector<LevelUpdate> updates;
+    updates.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        Side side = (rng() & 1) ? Side::Bid : Side::Ask;
+        Price price = side == Side::Bid ? 6500000 - offset(rng) : 6500000 + offset(rng);
+        updates.push_back({side, price, (rng() % 4) ? size(rng) : 0});
+    }
+    return updates;
+}
+
+template <typename Book>
+void run(const std::string& name, Book& book, const std::vector<Snapshot>& snapshots,
+         const std::vector<LevelUpdate>& updates, size_t depth) {
+    const size_t iterations = 1000000;
+    std::vector<BookLevel> top(depth);
+
+    printResult(name + " snapshot", measureNsPerOp(iterations / 4, [&](size_t i) {
+        const auto& snapshot = snapshots[i % snapshots.size()];
+        book.setOrderBook(snapshot.bids, snapshot.asks);
+        doNotOptimize(book.bestBid());
+    }));
+    printResult(name + " level update", measureNsPerOp(iterations, [&](size_t i) {
+        const auto& update = updates[i % updates.size()];
+        book.applyUpdate(update.side, update.price, update.volume);
+        doNotOptimize(book.bestAsk());
+    }));
+    printResult(name + " top " + std::to_string(depth) + " read", measureNsPerOp(iterations, [&](size_t) {
+        doNotOptimize(book.topBids(depth, top.data()));
+        doNotOptimize(top[0].volume);
+    }));
+}
+
+} // namespace
+
+int main() {
+    constexpr size_t depth = DEFAULT_BOOK_DEPTH;
+    auto snapshots = makeSnapshots(4096, depth);
+    auto updates = makeUpdates(1 << 16);
+
+    std::cout << "Book footprint (" << depth << " levels per side)\n"
+              << "  FixedDepthBook<" << depth << ">               " << sizeof(FixedDepthBook<depth>) << " bytes inline\n"
+              << "  FixedDepthBook<" << depth << ", int32_t>      " << sizeof(FixedDepthBook<depth, std::int32_t>)
+              << " bytes inline\n"
+              << "  FixedDepthBook<bookDepth(\"btcusd\")>  " << sizeof(FixedDepthBook<bookDepth("btcusd")>)
+              << " bytes inline\n\n";
+
+    FixedDepthBook<depth> fixedBook;
+    run("FixedDepthBook", fixedBook, snapshots, updates, depth);
+
+    FixedDepthBook<depth, std::int32_t> narrowBook;
+    run("FixedDepthBook int32", narrowBook, snapshots, updates, depth);
+
+    OrderBook ladderBook(BookMode::L2);
+    run("OrderBook L2", ladderBook, snapshots, updates, depth);
+    return 0;
+}
@@ -0,0 +1,134 @@
+// Compares the tick-indexed PriceLadder book against the std::map-backed book it replaced.
+#include "BenchUtil.h"
+#include "trading/OrderBook.h"
+#include "trading/PriceLadder.h"
+
+#include <deque>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace {
+
+// The book as it was before the ladder: one red-black tree per side
+class MapOrderBook {
+public:
+    void setOrderBook(const std::vector<Order>& newBids, const std::vector<Order>& newAsks) {
+        bids.clear();
+        asks.clear();
+        for (const auto& bid : newBids) bids[bid.price].push_back(bid);
+        for (const auto& ask : newAsks) asks[ask.price].push_back(ask);
+    }
+
+    Price bestBid() const { return bids.empty() ? -1 : bids.rbegin()->first; }
+
+    Price bestAsk() const { return asks.empty() ? -1 : asks.begin()->first; }
+
+private:
+    std::map<Price, std::deque<Order>> bids;
+    std::map<Price, std::deque<Order>> asks;
+};
+
+// Random level insert/erase around a drifting best price, as seen with L2 deltas
+struct Update {
+    Price price;
+    bool erase;
+};
+
+std::vector<Update> makeUpdates(size_t count) {
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<int> step(-2, 2);
+    std::uniform_int_distribution<int> offset(0, 60);
+    std::vector<Update> updates;
+    updates.reserve(count);
+    Price best = 6500000;
+    for (size_t i = 0; i < count; ++i) {
+        if (i % 16 == 0) best += step(rng);
+        updates.push_back({best - offset(rng), (rng() & 1) != 0});
+    }
+    return updates;
+}
+
+} // namespace
+
+int main() {
+    const size_t iterations = 1000000;
+
+    std::cout << "Snapshot rebuild + best bid/ask\n";
+    for (int depth : {10, 50}) {
+        auto snapshots = makeSnapshots(4096, depth);
+        std::string suffix = " (" + std::to_string(depth) + " levels)";
+
+        MapOrderBook mapBook;
+        printResult("std::map book" + suffix, measureNsPerOp(iterations / 4, [&](size_t i) {
+            const auto& snapshot = snapshots[i % snapshots.size()];
+            mapBook.setOrderBook(snapshot.bids, snapshot.asks);
+            doNotOptimize(mapBook.bestBid());
+            doNotOptimize(mapBook.bestAsk());
+        }));
+
+        OrderBook ladderBook;
+        printResult("ladder book" + suffix, measureNsPerOp(iterations / 4, [&](size_t i) {
+            const auto& snapshot = snapshots[i % snapshots.size()];
+            ladderBook.setOrderBook(snapshot.bids, snapshot.asks);
+            doNotOptimize(ladderBook.bestBid());
+            doNotOptimize(ladderBook.bestAsk());
+        }));
+
+        OrderBook l2Book(BookMode::L2);
+        printResult("ladder book, L2 levels" + suffix, measureNsPerOp(iterations / 4, [&](size_t i) {
+            const auto& snapshot = snapshots[i % snapshots.size()];
+            l2Book.setOrderBook(snapshot.bids, snapshot.asks);
+            doNotOptimize(l2Book.bestBid());
+            doNotOptimize(l2Book.bestAsk());
+        }));
+    }
+
+    std::cout << "\nLevel insert/erase + best price (one side)\n";
+    auto updates = makeUpdates(1 << 16);
+
+    std::map<Price, Quantity> mapSide;
+    printResult("std::map", measureNsPerOp(iterations, [&](size_t i) {
+        const Update& update = updates[i % updates.size()];
+        if (update.erase) {
+            mapSide.erase(update.price);
+        } else {
+            mapSide[update.price] += 1;
+        }
+        doNotOptimize(mapSide.empty() ? -1 : mapSide.rbegin()->first);
+    }));
+
+    PriceLadder<Quantity> ladderSide(Side::Bid);
+    printResult("PriceLadder", measureNsPerOp(iterations, [&](size_t i) {
+        const Update& update = updates[i % updates.size()];
+        if (update.erase) {
+            ladderSide.erase(update.price);
+        } else {
+            ladderSide.insert(update.price) += 1;
+        }
+        doNotOptimize(ladderSide.bestPrice());
+    }));
+
+    std::cout << "\nTop-5 read from a 50-level book\n";
+    auto deepSnapshots = makeSnapshots(1, 50);
+    OrderBook deepBook(BookMode::L2);
+    deepBook.setOrderBook(deepSnapshots[0].bids, deepSnapshots[0].asks);
+    printResult("getBids() copy, first 5", measureNsPerOp(iterations, [&](size_t) {
+        auto levels = deepBook.getBids();
+        doNotOptimize(levels[4].volume);
+    }));
+    BookLevel top[5];
+    printResult("topBids(5)", measureNsPerOp(iterations, [&](size_t) {
+        doNotOptimize(deepBook.topBids(5, top));
+        doNotOptimize(top[4].volume);
+    }));
+
+    std::cout << "\nBest price read\n";
+    printResult("std::map rbegin", measureNsPerOp(iterations * 10, [&](size_t) {
+        doNotOptimize(mapSide.rbegin()->first);
+    }));
+    printResult("PriceLadder bestPrice", measureNsPerOp(iterations * 10, [&](size_t) {
+        doNotOptimize(ladderSide.bestPrice());
+    }));
+    return 0;
+}
@@ -0,0 +1,61 @@
+// Cost on the calling thread of logging one feed event: the old pattern of
+// taking a global mutex and writing through std::ostream, against encoding
+// the record into the thread's AsyncLog ring for the drain thread to format.
+// Both write to /dev/null, so the stream rows are a lower bound on a real
+// file or terminal.
+#include "BenchUtil.h"
+#include "trading/AsyncLog.h"
+
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace {
+
+// Times fn in bursts that fit in a ring, letting the drain thread empty it
+// between bursts, so no record is dropped and only the caller's cost counts
+template <typename Fn>
+double measureBatched(size_t iterations, Fn&& fn) {
+    const size_t burst = 1000;
+    std::chrono::steady_clock::duration elapsed{};
+    for (size_t done = 0; done < iterations; done += burst) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = done; i < done + burst; ++i) fn(i);
+        elapsed += std::chrono::steady_clock::now() - start;
+        std::this_thread::sleep_for(std::chrono::milliseconds(3));
+    }
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+}
+
+} // namespace
+
+int main() {
+    const size_t iterations = 1000000;
+    const std::string instrument = "btcusd";
+    std::ofstream sink("/dev/null");
+    std::mutex outputMutex;
+
+    std::cout << "Logging one line per update\n";
+    printResult("mutex + ostream, 1 string", measureNsPerOp(iterations, [&](size_t) {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        sink << "📈 [" << instrument << "] Orderbook updated\n";
+    }));
+    printResult("mutex + ostream, string + 3 numbers", measureNsPerOp(iterations, [&](size_t i) {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        sink << "📈 [" << instrument << "] bid " << 6499999 + static_cast<long>(i % 7) << " ask " << 6500001
+             << " spread " << 0.25 << " bps\n";
+    }));
+
+    AsyncLog log(sink, sink);
+    static constexpr LogSite updated{LogLevel::Info, "📈 [{}] Orderbook updated\n"};
+    static constexpr LogSite quote{LogLevel::Info, "📈 [{}] bid {} ask {} spread {} bps\n"};
+    printResult("AsyncLog, 1 string", measureBatched(iterations, [&](size_t) {
+        log.write(updated, instrument);
+    }));
+    printResult("AsyncLog, string + 3 numbers", measureBatched(iterations, [&](size_t i) {
+        log.write(quote, instrument, 6499999 + static_cast<long>(i % 7), 6500001, 0.25);
+    }));
+    std::cout << "  records dropped on full rings: " << log.dropped() << "\n";
+    return 0;
+}
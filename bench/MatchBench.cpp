@@ -0,0 +1,124 @@
+// Fills/sec when uncrossing deep books: the old one-match-per-call loop over
+// std::map versus OrderBook::matchOrders() calls versus a single match() sweep.
+#include "BenchUtil.h"
+#include "trading/OrderBook.h"
+
+#include <deque>
+#include <map>
+#include <vector>
+
+namespace {
+
+// The std::map book and matchOrders() as they were before the ladder
+class MapOrderBook {
+public:
+    void addBid(Price price, Quantity volume) { bids[price].emplace_back(price, volume); }
+
+    void addAsk(Price price, Quantity volume) { asks[price].emplace_back(price, volume); }
+
+    bool matchOrders() {
+        while (!bids.empty() && !asks.empty()) {
+            auto bestBidIt = std::prev(bids.end());
+            auto bestAskIt = asks.begin();
+            if (bestBidIt->first < bestAskIt->first) break;
+
+            auto& bidQueue = bestBidIt->second;
+            auto& askQueue = bestAskIt->second;
+            Order& bid = bidQueue.front();
+            Order& ask = askQueue.front();
+
+            Quantity tradeVolume = std::min(bid.volume, ask.volume);
+            bid.volume -= tradeVolume;
+            ask.volume -= tradeVolume;
+            if (bid.volume == 0) bidQueue.pop_front();
+            if (ask.volume == 0) askQueue.pop_front();
+            if (bidQueue.empty()) bids.erase(bestBidIt);
+            if (askQueue.empty()) asks.erase(bestAskIt);
+            return true;
+        }
+        return false;
+    }
+
+private:
+    std::map<Price, std::deque<Order>> bids;
+    std::map<Price, std::deque<Order>> asks;
+};
+
+// Bids stacked above asks so every level crosses: levels x ordersPerLevel orders
+// a side, with uneven sizes so fills split orders
+template <typename Book>
+void buildCrossedBook(Book& book, int levels, int ordersPerLevel) {
+    for (int level = 0; level < levels; ++level) {
+        for (int order = 0; order < ordersPerLevel; ++order) {
+            book.addAsk(100000 + level, 3 + (order % 5));
+        }
+    }
+    for (int level = 0; level < levels; ++level) {
+        for (int order = 0; order < ordersPerLevel; ++order) {
+            book.addBid(100000 + levels + level, 2 + (order % 7));
+        }
+    }
+}
+
+struct Result {
+    double seconds = 0;
+    size_t fills = 0;
+};
+
+template <typename MakeBook, typename Uncross>
+Result run(int rounds, int levels, int ordersPerLevel, MakeBook&& makeBook, Uncross&& uncross) {
+    Result result;
+    for (int round = 0; round < rounds; ++round) {
+        auto book = makeBook();
+        buildCrossedBook(book, levels, ordersPerLevel);
+        auto start = std::chrono::steady_clock::now();
+        result.fills += uncross(book);
+        result.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return result;
+}
+
+void report(const std::string& name, const Result& result) {
+    std::cout << "  " << std::left << std::setw(40) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << result.fills / result.seconds / 1e6 << " M fills/s"
+              << std::setw(12) << result.seconds * 1e9 / result.fills << " ns/fill\n";
+}
+
+} // namespace
+
+int main() {
+    FillSink sink;
+    sink.reserve(1 << 16);
+    for (auto [levels, ordersPerLevel] : {std::pair<int, int>{200, 1}, {100, 8}, {20, 50}}) {
+        const int rounds = 2000;
+        std::cout << "Crossed book: " << levels << " levels x " << ordersPerLevel << " orders a side\n";
+
+        report("std::map matchOrders() loop", run(rounds, levels, ordersPerLevel, [] { return MapOrderBook(); },
+            [](MapOrderBook& book) {
+                size_t fills = 0;
+                while (book.matchOrders()) ++fills;
+                return fills;
+            }));
+
+        report("OrderBook matchOrders() loop", run(rounds, levels, ordersPerLevel, [] { return OrderBook(BookMode::L3); },
+            [](OrderBook& book) {
+                size_t fills = 0;
+                while (book.matchOrders()) ++fills;
+                return fills;
+            }));
+
+        report("OrderBook match(FillSink)", run(rounds, levels, ordersPerLevel, [] { return OrderBook(BookMode::L3); },
+            [&sink](OrderBook& book) {
+                sink.clear();
+                return book.match(sink);
+            }));
+
+        report("OrderBook L2 match(FillSink)", run(rounds, levels, ordersPerLevel, [] { return OrderBook(BookMode::L2); },
+            [&sink](OrderBook& book) {
+                sink.clear();
+                return book.match(sink);
+            }));
+        std::cout << "\n";
+    }
+    return 0;
+}
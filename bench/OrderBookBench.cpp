@@ -0,0 +1,131 @@
+// Compares the integer tick-keyed OrderBook against the previous double-keyed book.
+#include "BenchUtil.h"
+#include "trading/Instrument.h"
+#include "trading/OrderBook.h"
+
+#include <deque>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+
+// The book as it was before prices became integer ticks
+class DoubleOrderBook {
+public:
+    struct DoubleOrder {
+        double price;
+        double volume;
+    };
+
+    void setOrderBook(const std::vector<std::pair<double, double>>& newBids,
+                      const std::vector<std::pair<double, double>>& newAsks) {
+        bids.clear();
+        asks.clear();
+        for (const auto& [price, volume] : newBids) bids[price].push_back({price, volume});
+        for (const auto& [price, volume] : newAsks) asks[price].push_back({price, volume});
+    }
+
+    double bestBid() const { return bids.empty() ? -1.0 : bids.rbegin()->first; }
+
+    double bestAsk() const { return asks.empty() ? -1.0 : asks.begin()->first; }
+
+private:
+    std::map<double, std::deque<DoubleOrder>> bids;
+    std::map<double, std::deque<DoubleOrder>> asks;
+};
+
+using DecimalLevels = std::vector<std::pair<double, double>>;
+
+struct DecimalSnapshot {
+    DecimalLevels bids;
+    DecimalLevels asks;
+};
+
+// Random-walk BTC-like snapshots, 10 levels a side, as they would come out of the JSON feed
+std::vector<DecimalSnapshot> makeDecimalSnapshots(size_t count, double tickSize) {
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<int> step(-3, 3);
+    std::uniform_int_distribution<int> gap(1, 4);
+    std::uniform_real_distribution<double> size(0.001, 2.5);
+
+    std::vector<DecimalSnapshot> snapshots(count);
+    long mid = 6500000;
+    for (auto& snapshot : snapshots) {
+        mid += step(rng);
+        long bid = mid - 1;
+        long ask = mid + 1;
+        for (int level = 0; level < 10; ++level) {
+            snapshot.bids.emplace_back(bid * tickSize, size(rng));
+            snapshot.asks.emplace_back(ask * tickSize, size(rng));
+            bid -= gap(rng);
+            ask += gap(rng);
+        }
+    }
+    return snapshots;
+}
+
+} // namespace
+
+int main() {
+    const InstrumentSpec& spec = getInstrumentSpec("btcusd");
+    const size_t snapshotCount = 4096;
+    const size_t iterations = 500000;
+    auto snapshots = makeDecimalSnapshots(snapshotCount, spec.tickSize);
+
+    std::cout << "Snapshot rebuild (10 levels a side) + best bid/ask\n";
+
+    DoubleOrderBook doubleBook;
+    double doubleNs = measureNsPerOp(iterations, [&](size_t i) {
+        const auto& snapshot = snapshots[i % snapshotCount];
+        doubleBook.setOrderBook(snapshot.bids, snapshot.asks);
+        doNotOptimize(doubleBook.bestBid());
+        doNotOptimize(doubleBook.bestAsk());
+    });
+    printResult("double-keyed std::map", doubleNs);
+
+    OrderBook tickBook;
+    std::vector<Order> bids;
+    std::vector<Order> asks;
+    double tickNs = measureNsPerOp(iterations, [&](size_t i) {
+        const auto& snapshot = snapshots[i % snapshotCount];
+        bids.clear();
+        asks.clear();
+        for (const auto& [price, volume] : snapshot.bids) bids.emplace_back(spec.toTicks(price), spec.toLots(volume));
+        for (const auto& [price, volume] : snapshot.asks) asks.emplace_back(spec.toTicks(price), spec.toLots(volume));
+        tickBook.setOrderBook(bids, asks);
+        doNotOptimize(tickBook.bestBid());
+        doNotOptimize(tickBook.bestAsk());
+    });
+    printResult("tick-keyed OrderBook (incl. conversion)", tickNs);
+
+    std::cout << "\nLevel lookup in a 10000-level map\n";
+
+    std::map<double, int> doubleLevels;
+    std::map<Price, int> tickLevels;
+    std::vector<double> probes;
+    for (int i = 0; i < 10000; ++i) {
+        doubleLevels[(6500000 + i) * spec.tickSize] = i;
+        tickLevels[6500000 + i] = i;
+    }
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<int> pick(0, 9999);
+    for (int i = 0; i < 4096; ++i) probes.push_back((6500000 + pick(rng)) * spec.tickSize);
+    std::vector<Price> tickProbes;
+    for (double probe : probes) tickProbes.push_back(spec.toTicks(probe));
+
+    printResult("std::map<double>::find", measureNsPerOp(iterations, [&](size_t i) {
+        doNotOptimize(doubleLevels.find(probes[i % probes.size()]));
+    }));
+    printResult("std::map<Price>::find", measureNsPerOp(iterations, [&](size_t i) {
+        doNotOptimize(tickLevels.find(tickProbes[i % tickProbes.size()]));
+    }));
+
+    // The same price reached through different arithmetic must map to a single level
+    std::set<double> doubleKeys = {0.3, 0.1 + 0.2};
+    std::set<Price> tickKeys = {spec.toTicks(0.3), spec.toTicks(0.1 + 0.2)};
+    std::cout << "\nDistinct levels for 0.3 and 0.1+0.2: double=" << doubleKeys.size()
+              << " ticks=" << tickKeys.size() << "\n";
+    return 0;
+}
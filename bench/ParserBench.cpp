@@ -0,0 +1,134 @@
+// Turning an sFOX orderbook frame into the best-first tick/lot levels that
+// setOrderBook takes: the original handler (json DOM, copy the levels into a
+// vector<json>, sort calling get<double>() per comparison, rebuild a json),
+// the DOM with conversion at ingest, and SfoxParser with top-K selection.
+#include "BenchUtil.h"
+#include "trading/Instrument.h"
+#include "trading/SfoxParser.h"
+
+#include <algorithm>
+#include <json.hpp>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace {
+
+constexpr size_t DEPTH = 20;
+const InstrumentSpec SPEC{0.01, 1e-8};
+
+// Frames shaped like the feed's: levels in no particular order, each with
+// its source exchange, and the payload's metadata fields around them
+std::vector<std::string> makeMessages(size_t count, size_t levelsPerSide) {
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<int> offset(1, 5000);
+    std::uniform_real_distribution<double> size(0.0001, 12.5);
+    const char* exchanges[] = {"coinbase", "kraken", "bitstamp", "gemini", "binanceus"};
+
+    std::vector<std::string> messages;
+    for (size_t i = 0; i < count; ++i) {
+        std::ostringstream out;
+        out.precision(10);
+        auto side = [&](int sign) {
+            out << "[";
+            for (size_t level = 0; level < levelsPerSide; ++level) {
+                out << (level ? "," : "") << "[" << 65000.0 + sign * offset(rng) * 0.01 << "," << size(rng)
+                    << ",\"" << exchanges[rng() % 5] << "\"]";
+            }
+            out << "]";
+        };
+        out << "{\"type\":\"orderbook\",\"sequence\":" << 1000 + i << ",\"recipient\":\"orderbook.sfox.btcusd\","
+            << "\"timestamp\":" << 1700000000000000000LL + static_cast<long long>(i) * 1000000 << ",\"payload\":{\"bids\":";
+        side(-1);
+        out << ",\"asks\":";
+        side(1);
+        out << ",\"market_making\":{\"bids\":[],\"asks\":[]},\"timestamps\":{\"coinbase\":[1700000000,1700000001]},"
+            << "\"lastupdated\":1700000000123,\"pair\":\"btcusd\",\"currency\":\"usd\",\"lastpublished\":1700000000124}}";
+        messages.push_back(out.str());
+    }
+    return messages;
+}
+
+void originalPath(const std::string& message, std::vector<Order>& bids, std::vector<Order>& asks) {
+    auto payload = json::parse(message);
+    const auto& data = payload["payload"];
+    json orderbook_data;
+
+    std::vector<json> sorted_bids = data["bids"];
+    std::sort(sorted_bids.begin(), sorted_bids.end(), [](const json& a, const json& b) {
+        return a[0].get<double>() > b[0].get<double>();
+    });
+    json top_bids = json::array();
+    for (size_t i = 0; i < std::min(sorted_bids.size(), DEPTH); ++i) top_bids.push_back(sorted_bids[i]);
+    orderbook_data["bids"] = top_bids;
+
+    std::vector<json> sorted_asks = data["asks"];
+    std::sort(sorted_asks.begin(), sorted_asks.end(), [](const json& a, const json& b) {
+        return a[0].get<double>() < b[0].get<double>();
+    });
+    json top_asks = json::array();
+    for (size_t i = 0; i < std::min(sorted_asks.size(), DEPTH); ++i) top_asks.push_back(sorted_asks[i]);
+    orderbook_data["asks"] = top_asks;
+
+    bids.clear();
+    asks.clear();
+    for (const auto& level : orderbook_data["bids"]) {
+        bids.emplace_back(SPEC.toTicks(level[0].get<double>()), SPEC.toLots(level[1].get<double>()));
+    }
+    for (const auto& level : orderbook_data["asks"]) {
+        asks.emplace_back(SPEC.toTicks(level[0].get<double>()), SPEC.toLots(level[1].get<double>()));
+    }
+}
+
+void domPath(const std::string& message, std::vector<Order>& bids, std::vector<Order>& asks) {
+    auto payload = json::parse(message);
+    const auto& data = payload["payload"];
+    auto toLevels = [](const json& entries, std::vector<Order>& levels) {
+        levels.clear();
+        for (const auto& entry : entries) {
+            if (entry.size() >= 2) levels.emplace_back(SPEC.toTicks(entry[0].get<double>()), SPEC.toLots(entry[1].get<double>()));
+        }
+    };
+    toLevels(data["bids"], bids);
+    std::sort(bids.begin(), bids.end(), [](const Order& a, const Order& b) { return a.price > b.price; });
+    bids.erase(bids.begin() + std::min(bids.size(), DEPTH), bids.end());
+    toLevels(data["asks"], asks);
+    std::sort(asks.begin(), asks.end(), [](const Order& a, const Order& b) { return a.price < b.price; });
+    asks.erase(asks.begin() + std::min(asks.size(), DEPTH), asks.end());
+}
+
+} // namespace
+
+int main() {
+    std::vector<Order> bids;
+    std::vector<Order> asks;
+    SfoxMessage parsed;
+
+    for (size_t levels : {50, 200}) {
+        const auto messages = makeMessages(64, levels);
+        const size_t iterations = 400000 / levels;
+        size_t bytes = 0;
+        for (const auto& message : messages) bytes += message.size();
+
+        std::cout << levels << " levels per side, top " << DEPTH << " kept, ~" << bytes / messages.size()
+                  << " bytes per frame\n";
+        printResult("json DOM + sort vector<json> (original)", measureNsPerOp(iterations, [&](size_t i) {
+            originalPath(messages[i % messages.size()], bids, asks);
+            doNotOptimize(bids.data());
+        }));
+        printResult("json DOM + convert, sort ticks", measureNsPerOp(iterations, [&](size_t i) {
+            domPath(messages[i % messages.size()], bids, asks);
+            doNotOptimize(bids.data());
+        }));
+        printResult("SfoxParser + selectTopLevels", measureNsPerOp(iterations, [&](size_t i) {
+            SfoxParser::parse(messages[i % messages.size()], parsed);
+            selectTopLevels(parsed.bids, Side::Bid, SPEC, DEPTH, bids);
+            selectTopLevels(parsed.asks, Side::Ask, SPEC, DEPTH, asks);
+            doNotOptimize(bids.data());
+        }));
+    }
+    return 0;
+}
@@ -0,0 +1,48 @@
+// Per-message cost of reaching an instrument's state: a std::string keyed
+// unordered_map behind a mutex (the old global_orderbooks), a lock-free
+// InstrumentRegistry lookup by symbol, and indexing by an interned id.
+#include "BenchUtil.h"
+#include "trading/InstrumentRegistry.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct Entry {
+    std::uint64_t updates = 0;
+};
+
+} // namespace
+
+int main() {
+    const size_t iterations = 4000000;
+    const std::vector<std::string> symbols = {"btcusd", "ethusd", "ltcusd", "bchusd", "solusd",
+                                              "linkusd", "dotusd", "dogeusd", "xrpusd", "adausd"};
+
+    std::unordered_map<std::string, std::unique_ptr<Entry>> map;
+    std::mutex mapMutex;
+    InstrumentRegistry<Entry> registry;
+    std::vector<InstrumentId> ids;
+    for (const auto& symbol : symbols) {
+        map[symbol] = std::make_unique<Entry>();
+        ids.push_back(registry.intern(symbol));
+    }
+
+    std::cout << "Instrument lookup, " << symbols.size() << " symbols\n";
+    printResult("unordered_map<string> under mutex", measureNsPerOp(iterations, [&](size_t i) {
+        std::lock_guard<std::mutex> lock(mapMutex);
+        ++map.find(symbols[i % symbols.size()])->second->updates;
+    }));
+    printResult("InstrumentRegistry::find by symbol", measureNsPerOp(iterations, [&](size_t i) {
+        ++registry[registry.find(symbols[i % symbols.size()])].updates;
+    }));
+    printResult("InstrumentRegistry by interned id", measureNsPerOp(iterations, [&](size_t i) {
+        ++registry[ids[i % ids.size()]].updates;
+    }));
+    doNotOptimize(registry[ids[0]].updates);
+    return 0;
+}
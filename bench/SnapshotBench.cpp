@@ -0,0 +1,159 @@
+// Reader and writer cost of handing a live book to other threads: copying the
+// OrderBook under a shared mutex (the old getOrderBook) against loading a
+// published immutable snapshot, or just the seqlocked BBO, and the writer's
+// publish cost while readers load.
+#include "BenchUtil.h"
+#include "trading/BookSnapshot.h"
+#include "trading/OrderBook.h"
+#include "trading/TopOfBook.h"
+
+#include <atomic>
+#include <ctime>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Reader loop run while a feed thread keeps updating the book
+template <typename Publish, typename Read>
+void contended(const std::string& name, const std::vector<Snapshot>& snapshots, Publish&& publish, Read&& read) {
+    std::atomic<bool> running{true};
+    std::atomic<size_t> updates{0};
+    std::thread feed([&] {
+        for (size_t i = 0; running.load(std::memory_order_relaxed); ++i) {
+            publish(snapshots[i % snapshots.size()]);
+            updates.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    while (updates.load(std::memory_order_relaxed) == 0) {
+        std::this_thread::yield();
+    }
+
+    double readNs = measureNsPerOp(200000, [&](size_t) { read(); });
+    running = false;
+    feed.join();
+    printResult(name + " read, feed running", readNs);
+    std::cout << "    feed published " << updates.load() << " updates meanwhile\n";
+}
+
+// CPU time the calling thread has used, which unlike wall time leaves out the
+// slices the scheduler gives other threads
+double threadCpuNs() {
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return static_cast<double>(now.tv_sec) * 1e9 + static_cast<double>(now.tv_nsec);
+}
+
+// Writer loop run while reader threads keep loading, to show readers do not
+// hold up publish. With fewer cores than threads the wall time also includes
+// the readers' scheduler slices, so the writer's own CPU time is shown too.
+template <typename Publish, typename Read>
+void contendedWriter(const std::string& name, int readers, const std::vector<Snapshot>& snapshots, Publish&& publish,
+                     Read&& read) {
+    std::atomic<bool> running{true};
+    std::atomic<size_t> reads{0};
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&] {
+            while (running.load(std::memory_order_relaxed)) {
+                read();
+                reads.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    while (readers > 0 && reads.load(std::memory_order_relaxed) == 0) {
+        std::this_thread::yield();
+    }
+
+    const size_t iterations = 200000;
+    double cpuStart = threadCpuNs();
+    double publishNs = measureNsPerOp(iterations, [&](size_t i) { publish(snapshots[i % snapshots.size()]); });
+    double cpuNs = (threadCpuNs() - cpuStart) / static_cast<double>(iterations);
+    running = false;
+    for (auto& thread : threads) thread.join();
+    printResult(name + ", " + std::to_string(readers) + " reader(s) loading", publishNs);
+    printResult("  writer CPU time", cpuNs);
+    std::cout << "    readers loaded " << reads.load() << " times meanwhile\n";
+}
+
+} // namespace
+
+int main() {
+    const size_t iterations = 200000;
+    auto snapshots = makeSnapshots(1024, 20);
+
+    std::cout << "Single thread\n";
+    std::mutex bookMutex;
+    OrderBook lockedBook(BookMode::L2);
+    lockedBook.setOrderBook(snapshots[0].bids, snapshots[0].asks);
+    printResult("OrderBook copy under mutex", measureNsPerOp(iterations, [&](size_t) {
+        std::lock_guard<std::mutex> lock(bookMutex);
+        OrderBook copy = lockedBook;
+        doNotOptimize(copy.bestBid());
+    }));
+
+    OrderBook feedBook(BookMode::L2);
+    SnapshotSlot slot;
+    feedBook.setOrderBook(snapshots[0].bids, snapshots[0].asks);
+    slot.publish(feedBook);
+    printResult("SnapshotSlot load", measureNsPerOp(iterations, [&](size_t) {
+        auto view = slot.load();
+        doNotOptimize(view->bestBid());
+    }));
+
+    TopOfBookCache top;
+    top.publish(feedBook, 0, 0);
+    printResult("TopOfBookCache load", measureNsPerOp(iterations, [&](size_t) {
+        doNotOptimize(top.load());
+    }));
+    printResult("TopOfBookCache publish (writer)", measureNsPerOp(iterations, [&](size_t i) {
+        top.publish(feedBook, 0, static_cast<std::int64_t>(i));
+    }));
+    printResult("setOrderBook + publish (writer)", measureNsPerOp(iterations, [&](size_t i) {
+        const auto& snapshot = snapshots[i % snapshots.size()];
+        feedBook.setOrderBook(snapshot.bids, snapshot.asks);
+        slot.publish(feedBook);
+    }));
+
+    std::cout << "\nWith a feed thread\n";
+    contended("OrderBook copy under mutex", snapshots,
+        [&](const Snapshot& snapshot) {
+            std::lock_guard<std::mutex> lock(bookMutex);
+            lockedBook.setOrderBook(snapshot.bids, snapshot.asks);
+        },
+        [&] {
+            std::lock_guard<std::mutex> lock(bookMutex);
+            OrderBook copy = lockedBook;
+            doNotOptimize(copy.bestBid());
+        });
+    contended("SnapshotSlot load", snapshots,
+        [&](const Snapshot& snapshot) {
+            feedBook.setOrderBook(snapshot.bids, snapshot.asks);
+            slot.publish(feedBook);
+        },
+        [&] {
+            auto view = slot.load();
+            doNotOptimize(view->bestBid());
+        });
+    contended("TopOfBookCache load", snapshots,
+        [&](const Snapshot& snapshot) {
+            feedBook.setOrderBook(snapshot.bids, snapshot.asks);
+            top.publish(feedBook, 0, 0);
+        },
+        [&] { doNotOptimize(top.load()); });
+
+    std::cout << "\nWriter with reader threads\n";
+    for (int readers : {0, 1, 2}) {
+        contendedWriter("setOrderBook + publish", readers, snapshots,
+            [&](const Snapshot& snapshot) {
+                feedBook.setOrderBook(snapshot.bids, snapshot.asks);
+                slot.publish(feedBook);
+            },
+            [&] {
+                auto view = slot.load();
+                doNotOptimize(view->bestBid());
+            });
+    }
+    return 0;
+}
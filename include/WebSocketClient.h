@@ -1,15 +1,32 @@
 #pragma once
 
+#include <iosfwd>
+#include <memory>
 #include <string>
 #include <vector>
-#include "trading/OrderBook.h"
+#include "trading/BookSnapshot.h"
+#include "trading/Instrument.h"
+#include "trading/TopOfBook.h"
 
 class WebSocketClient {
 public:
-    void connect(const std::vector<std::string>& instruments);
+    // Subscribes to the instruments, packing many feeds onto each connection, and
+    // drives the connections from `reactors` threads, each running one io_context.
+    // Blocks for as long as any connection is kept alive.
+    void connect(const std::vector<std::string>& instruments, size_t reactors = 1);
     
-    // Static methods to access orderbooks from anywhere
-    static OrderBook getOrderBook(const std::string& instrument);
+    // Static methods to access orderbooks from anywhere, without locking. Callers asking
+    // repeatedly can resolve the symbol once with findInstrument (NO_INSTRUMENT if unknown).
+    static InstrumentId findInstrument(const std::string& symbol);
+    // Latest published book, or an empty snapshot if the instrument is unknown or has no data yet
+    static std::shared_ptr<const BookSnapshot> getSnapshot(InstrumentId id);
+    static std::shared_ptr<const BookSnapshot> getSnapshot(const std::string& instrument);
+    // Best bid/offer only, without touching the book's levels; version 0 until the first update
+    static TopOfBook getTopOfBook(InstrumentId id);
+    static TopOfBook getTopOfBook(const std::string& instrument);
     static std::vector<std::string> getAvailableInstruments();
+    // One line per subscribed instrument with its book's counters (see BookStats),
+    // taken from the latest snapshot, so any thread can call it without touching the feed
+    static void dumpStats(std::ostream& out);
     static bool hasOrderBook(const std::string& symbol);
 };
\ No newline at end of file
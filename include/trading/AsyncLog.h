@@ -0,0 +1,217 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+enum class LogLevel : std::uint8_t { Debug, Info, Warn, Error };
+
+// Least severe level compiled in; log calls below it generate no code.
+// 0 debug, 1 info, 2 warn, 3 error.
+#ifndef LOG_LEVEL
+#define LOG_LEVEL 1
+#endif
+
+// A log statement: its level and a format with "{}" for each argument.
+// One static instance per call site, so records carry just its address.
+struct LogSite {
+    LogLevel level;
+    const char* format;
+};
+
+// Leads every record in a LogRing; site is null for the padding that
+// skips the end of the buffer when a record would not fit before it
+struct LogRecordHeader {
+    std::uint32_t size; // header and arguments, a multiple of 16
+    std::uint32_t argCount;
+    const LogSite* site;
+};
+
+namespace logdetail {
+
+enum class ArgType : std::uint8_t { Signed, Unsigned, Double, Bool, String };
+
+constexpr size_t MAX_STRING = 4096; // longer string arguments are truncated
+
+template <typename T>
+size_t encodedSize(const T& value) {
+    if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+        return 1 + sizeof(std::uint32_t) + std::min(std::string_view(value).size(), MAX_STRING);
+    } else {
+        static_assert(std::is_arithmetic_v<T>, "log arguments must be numbers or strings");
+        return 1 + sizeof(std::uint64_t);
+    }
+}
+
+template <typename Raw>
+char* put(char* out, ArgType type, Raw raw) {
+    *out++ = static_cast<char>(type);
+    std::memcpy(out, &raw, sizeof raw);
+    return out + sizeof raw;
+}
+
+template <typename T>
+char* encode(char* out, const T& value) {
+    if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+        std::string_view text = std::string_view(value).substr(0, MAX_STRING);
+        out = put(out, ArgType::String, static_cast<std::uint32_t>(text.size()));
+        std::memcpy(out, text.data(), text.size());
+        return out + text.size();
+    } else if constexpr (std::is_same_v<T, bool>) {
+        return put(out, ArgType::Bool, static_cast<std::uint64_t>(value));
+    } else if constexpr (std::is_floating_point_v<T>) {
+        return put(out, ArgType::Double, static_cast<double>(value));
+    } else if constexpr (std::is_signed_v<T>) {
+        return put(out, ArgType::Signed, static_cast<std::int64_t>(value));
+    } else {
+        return put(out, ArgType::Unsigned, static_cast<std::uint64_t>(value));
+    }
+}
+
+} // namespace logdetail
+
+// Byte ring of encoded records written by one thread and read by the drain
+// thread. A full ring drops the record rather than make the writer wait.
+class LogRing {
+public:
+    static constexpr size_t CAPACITY = 64 * 1024;
+
+    // Space for a record of size bytes, or nullptr if it does not fit
+    char* reserve(size_t size) {
+        size_t next = written;
+        size_t offset = next & (CAPACITY - 1);
+        size_t padding = CAPACITY - offset < size ? CAPACITY - offset : 0;
+        if (next + padding + size - cachedTail > CAPACITY) cachedTail = tail.load(std::memory_order_acquire);
+        if (size > CAPACITY / 4 || next + padding + size - cachedTail > CAPACITY) {
+            dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        if (padding) {
+            LogRecordHeader skip{static_cast<std::uint32_t>(padding), 0, nullptr};
+            std::memcpy(buffer + offset, &skip, sizeof skip);
+            next += padding;
+            offset = 0;
+        }
+        written = next + size;
+        return buffer + offset;
+    }
+
+    // Makes the reserved record visible to the drain thread
+    void publish() { head.store(written, std::memory_order_release); }
+
+    // Calls onRecord(header, arguments) for each published record and frees them; drain thread only
+    template <typename OnRecord>
+    size_t consume(OnRecord&& onRecord) {
+        size_t next = tail.load(std::memory_order_relaxed);
+        size_t end = head.load(std::memory_order_acquire);
+        size_t count = 0;
+        while (next != end) {
+            const char* at = buffer + (next & (CAPACITY - 1));
+            LogRecordHeader header;
+            std::memcpy(&header, at, sizeof header);
+            if (header.site) {
+                onRecord(header, at + sizeof header);
+                ++count;
+            }
+            next += header.size;
+        }
+        tail.store(next, std::memory_order_release);
+        return count;
+    }
+
+    std::uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    alignas(64) std::atomic<size_t> head{0}; // bytes published
+    size_t written = 0;                      // bytes reserved, writer only
+    size_t cachedTail = 0;                   // writer's last view of tail
+    std::atomic<std::uint64_t> dropped{0};
+    alignas(64) std::atomic<size_t> tail{0}; // bytes consumed
+    alignas(64) char buffer[CAPACITY];
+};
+
+// Logger whose callers only encode a format id and raw arguments into their
+// thread's LogRing, without locks, I/O or formatting. A background thread
+// drains the rings, formats the records and writes them: Debug and Info to
+// out, Warn and Error to err. Records from one thread keep their order.
+// Records from different threads are interleaved as they are drained.
+class AsyncLog {
+public:
+    AsyncLog(std::ostream& out, std::ostream& err);
+
+    // Writes what is left in the rings, then stops the drain thread
+    ~AsyncLog();
+
+    AsyncLog(const AsyncLog&) = delete;
+    AsyncLog& operator=(const AsyncLog&) = delete;
+
+    // The process logger used by the LOG_ macros, on std::cout and std::cerr
+    static AsyncLog& instance();
+
+    template <typename... Args>
+    void write(const LogSite& site, const Args&... args) {
+        size_t size = sizeof(LogRecordHeader) + (size_t(0) + ... + logdetail::encodedSize(args));
+        size = (size + 15) & ~size_t(15);
+        LogRing& ring = threadRing();
+        char* record = ring.reserve(size);
+        if (!record) return;
+
+        LogRecordHeader header{static_cast<std::uint32_t>(size), static_cast<std::uint32_t>(sizeof...(Args)), &site};
+        std::memcpy(record, &header, sizeof header);
+        [[maybe_unused]] char* out = record + sizeof header;
+        ((out = logdetail::encode(out, args)), ...);
+        ring.publish();
+    }
+
+    // Records lost to full rings so far
+    std::uint64_t dropped() const;
+
+private:
+    LogRing& threadRing() {
+        thread_local std::uint64_t owner = 0;
+        thread_local LogRing* ring = nullptr;
+        if (owner != id) {
+            ring = &registerThread();
+            owner = id;
+        }
+        return *ring;
+    }
+
+    LogRing& registerThread();
+    void run();
+    size_t drainOnce(std::vector<LogRing*>& rings, std::string& line);
+
+    const std::uint64_t id; // tells loggers apart in the thread-local ring cache
+    std::ostream& out;
+    std::ostream& err;
+    mutable std::mutex registration;
+    std::vector<std::pair<std::thread::id, std::unique_ptr<LogRing>>> rings;
+    std::atomic<size_t> ringCount{0};
+    std::atomic<bool> stopping{false};
+    std::uint64_t droppedReported = 0;
+    std::thread drainer;
+};
+
+#define LOG_AT(level, format, ...)                                   \
+    do {                                                             \
+        if constexpr (static_cast<int>(level) >= LOG_LEVEL) {        \
+            static constexpr LogSite logSite{level, format};         \
+            AsyncLog::instance().write(logSite, ##__VA_ARGS__);      \
+        }                                                            \
+    } while (0)
+
+#define LOG_DEBUG(format, ...) LOG_AT(LogLevel::Debug, format, ##__VA_ARGS__)
+#define LOG_INFO(format, ...) LOG_AT(LogLevel::Info, format, ##__VA_ARGS__)
+#define LOG_WARN(format, ...) LOG_AT(LogLevel::Warn, format, ##__VA_ARGS__)
+#define LOG_ERROR(format, ...) LOG_AT(LogLevel::Error, format, ##__VA_ARGS__)
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+struct AllocationStats {
+    std::uint64_t allocations = 0;       // requests made by the book's containers
+    std::uint64_t deallocations = 0;
+    std::uint64_t bytesInUse = 0;
+    std::uint64_t heapAllocations = 0;   // blocks the arena took from the global heap
+    std::uint64_t heapDeallocations = 0;
+    std::uint64_t heapBytes = 0;         // bytes currently held from the global heap
+};
+
+// memory_resource that forwards to an upstream resource and counts the traffic
+class CountingResource : public std::pmr::memory_resource {
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream);
+
+    std::uint64_t allocations = 0;
+    std::uint64_t deallocations = 0;
+    std::uint64_t bytesInUse = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    std::pmr::memory_resource* upstream;
+};
+
+// Per-book memory pool. Level and order storage is carved out of chunks the
+// pool takes from the global heap, so book churn stays off the allocator
+// shared with gRPC and websocketpp. Not thread-safe: a book and its arena
+// belong to a single writer thread, such as the feed reactor that applies its
+// updates, and other threads read published snapshots instead.
+class BookArena {
+public:
+    BookArena();
+
+    BookArena(const BookArena&) = delete;
+    BookArena& operator=(const BookArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &front; }
+
+    AllocationStats stats() const;
+
+private:
+    CountingResource heap{std::pmr::new_delete_resource()};
+    std::pmr::unsynchronized_pool_resource pool;
+    CountingResource front{&pool};
+};
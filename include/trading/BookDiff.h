@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "BookSnapshot.h"
+#include "OrderBook.h"
+
+enum class DeltaAction : std::uint8_t {
+    Add,    // a price level that was not there before
+    Modify, // same price, new volume or order count
+    Delete  // the level is gone; volume and orderCount are 0
+};
+
+struct LevelDelta {
+    DeltaAction action;
+    Side side;
+    Price price;
+    Quantity volume;
+    std::uint32_t orderCount;
+};
+
+// Computes the level changes that turn one version of a book into another
+// with one linear merge per side over best-first levels. Deltas are written
+// to a buffer owned by the engine and reused across calls, so a warm engine
+// does not allocate. Empty levels count as absent.
+class BookDiff {
+public:
+    // Each diff replaces the previous deltas and returns how many there are
+    size_t diff(const OrderBook& before, const OrderBook& after);
+
+    size_t diff(const BookSnapshot& before, const BookSnapshot& after);
+
+    // Against an incoming snapshot in setOrderBook form: levels sorted best
+    // first, with repeated prices summed into one level
+    size_t diff(const OrderBook& before, const std::vector<Order>& bids, const std::vector<Order>& asks);
+
+    // Bids first, then asks, each best price first
+    const std::vector<LevelDelta>& deltas() const { return changes; }
+
+    bool empty() const { return changes.empty(); }
+
+    // Brings a book holding the before levels up to date. Only volumes carry
+    // over: L2 levels written this way count as a single order.
+    void applyTo(OrderBook& book) const;
+
+private:
+    static const std::vector<BookLevel>& copyLevels(const OrderBook& book, Side side, std::vector<BookLevel>& levels);
+
+    std::vector<LevelDelta> changes;
+    std::vector<BookLevel> beforeLevels; // scratch copies of book sides, reused across calls
+    std::vector<BookLevel> afterLevels;
+};
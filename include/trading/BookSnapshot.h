@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "OrderBook.h"
+#include "PriceLevel.h"
+
+// Immutable copy of a book's levels at one point in the feed. Readers hold
+// it through a shared_ptr for as long as they need it; the feed keeps
+// publishing newer ones meanwhile.
+class BookSnapshot {
+public:
+    BookSnapshot() = default;
+
+    BookSnapshot(const OrderBook& book, std::uint64_t version);
+
+    // Publication number, 0 for the empty snapshot before the first update
+    std::uint64_t version() const { return sequence; }
+
+    // OrderBook::checksum() of the book the snapshot was taken from, so a
+    // replica applying the same updates can check it has not diverged
+    std::uint64_t checksum() const { return levelChecksum; }
+
+    // The source book's counters when the snapshot was taken
+    const BookStats& stats() const { return bookStats; }
+
+    Price bestBid() const { return bids.empty() ? -1 : bids.front().price; } // -1 if there are no bids
+
+    Price bestAsk() const { return asks.empty() ? -1 : asks.front().price; } // -1 if there are no asks
+
+    bool empty() const { return bids.empty() && asks.empty(); }
+
+    // Levels, best price first
+    const std::vector<BookLevel>& getBids() const { return bids; }
+
+    const std::vector<BookLevel>& getAsks() const { return asks; }
+
+    // Copies up to n best levels into out and returns how many were written
+    size_t topBids(size_t n, BookLevel* out) const;
+
+    size_t topAsks(size_t n, BookLevel* out) const;
+
+private:
+    friend class SnapshotSlot;
+
+    // Refills the snapshot from book, reusing the level vectors' capacity
+    void capture(const OrderBook& book, std::uint64_t version);
+
+    std::uint64_t sequence = 0;
+    std::uint64_t levelChecksum = 0;
+    BookStats bookStats;
+    std::vector<BookLevel> bids;
+    std::vector<BookLevel> asks;
+};
+
+// Single-writer publication point for one book's snapshots (read-copy-update).
+// The writer fills a spare snapshot off to the side and swaps it in; readers
+// load the current one and keep it as long as they like. Snapshots are
+// recycled rather than freed: the slot owns a few, and publish refills one
+// that neither is current nor held by a reader, so a warm slot does not
+// touch the heap. Only when readers hold every spare is a new one allocated.
+//
+// Lock-free: current is a plain atomic pointer to a node holding a
+// snapshot, and each node counts the loads copying its shared_ptr. A load
+// pins the node it read, checks it is still current and copies the
+// snapshot; the writer only refills nodes nobody has pinned, so it never
+// waits on a reader and a reader retries only when a publish lands in the
+// middle of its load.
+class SnapshotSlot {
+public:
+    SnapshotSlot();
+
+    SnapshotSlot(const SnapshotSlot&) = delete;
+    SnapshotSlot& operator=(const SnapshotSlot&) = delete;
+
+    // Writer only: captures book as the next version and makes it current
+    void publish(const OrderBook& book);
+
+    // Any thread: the latest published snapshot, never null
+    std::shared_ptr<const BookSnapshot> load() const;
+
+private:
+    static constexpr size_t POOL_SIZE = 3;
+
+    struct alignas(64) Node {
+        std::shared_ptr<BookSnapshot> snapshot;  // replaced or refilled by the writer only while unpinned
+        mutable std::atomic<std::uint32_t> pins{0}; // loads between reading current and copying snapshot
+    };
+
+    std::vector<std::unique_ptr<Node>> nodes; // writer only; grows only while loads pin every spare
+    std::atomic<Node*> current;
+    std::uint64_t published = 0; // writer only
+};
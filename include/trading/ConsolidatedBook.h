@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include "BookArena.h"
+#include "OrderBook.h"
+#include "PriceLadder.h"
+#include "PriceLevel.h"
+
+using VenueId = std::uint8_t;
+
+constexpr size_t MAX_VENUES = 8;
+
+constexpr VenueId NO_VENUE = UINT8_MAX;
+
+// One price of the consolidated book with each venue's share of it
+struct ConsolidatedLevel {
+    Price price = 0;
+    Quantity volume = 0;           // summed across venues
+    std::uint32_t venueMask = 0;   // bit v is set while venue v quotes this price
+    std::array<Quantity, MAX_VENUES> venueVolumes{};
+
+    void clear() {
+        volume = 0;
+        venueMask = 0;
+        venueVolumes.fill(0);
+    }
+};
+
+// Best bid and offer across venues, with the venues quoting each
+struct ConsolidatedQuote {
+    Price bid = -1; // -1 if no venue has bids
+    Quantity bidQty = 0;
+    std::uint32_t bidVenues = 0;
+    Price ask = -1; // -1 if no venue has asks
+    Quantity askQty = 0;
+    std::uint32_t askVenues = 0;
+};
+
+// Several venues' books for one asset merged into a single venue-tagged
+// view. The merge is kept rather than recomputed: each venue change adjusts
+// only the consolidated levels at the prices it touches, so NBBO and depth
+// reads never re-merge the venues. All venues must quote in the same ticks
+// and lots. The consolidated book can be crossed when venues disagree.
+class ConsolidatedBook {
+public:
+    ConsolidatedBook();
+
+    // Registers a venue; its id indexes venueVolumes and the venue masks.
+    // NO_VENUE once MAX_VENUES are registered.
+    VenueId addVenue(const std::string& name);
+
+    const std::string& venueName(VenueId venue) const { return venues[venue]; }
+
+    size_t venueCount() const { return venues.size(); }
+
+    // Sets one venue's volume at a price, 0 to remove it. O(1) inside the
+    // ladder window. This and the two calls below return false and change
+    // nothing for a venue that was never registered, NO_VENUE included.
+    bool applyUpdate(VenueId venue, Side side, Price price, Quantity volume);
+
+    // Makes venue's contribution match its book with one merge per side,
+    // touching only the levels whose volume for that venue changed
+    bool syncVenue(VenueId venue, const OrderBook& book);
+
+    // Withdraws everything a venue contributed, e.g. when its feed drops
+    bool clearVenue(VenueId venue);
+
+    ConsolidatedQuote nbbo() const;
+
+    Price bestBid() const { return bids.bestPrice(); } // -1 if there are no bids
+
+    Price bestAsk() const { return asks.bestPrice(); } // -1 if there are no asks
+
+    size_t levelCount(Side side) const { return side == Side::Bid ? bids.size() : asks.size(); }
+
+    // Copies up to n best levels into out and returns how many were written
+    size_t topBids(size_t n, ConsolidatedLevel* out) const;
+
+    size_t topAsks(size_t n, ConsolidatedLevel* out) const;
+
+    // Calls visitor(const ConsolidatedLevel&) for up to maxLevels levels, best first
+    template <typename Visitor>
+    void forEachBid(Visitor&& visitor, size_t maxLevels = std::numeric_limits<size_t>::max()) const {
+        bids.forEach([&visitor](Price, const ConsolidatedLevel& level) { visitor(level); }, maxLevels);
+    }
+
+    template <typename Visitor>
+    void forEachAsk(Visitor&& visitor, size_t maxLevels = std::numeric_limits<size_t>::max()) const {
+        asks.forEach([&visitor](Price, const ConsolidatedLevel& level) { visitor(level); }, maxLevels);
+    }
+
+private:
+    using Ladder = PriceLadder<ConsolidatedLevel>;
+
+    void syncSide(VenueId venue, Side side, const OrderBook& book);
+
+    std::vector<std::string> venues;
+    std::unique_ptr<BookArena> arena; // declared before the ladders that draw from it
+    Ladder bids;
+    Ladder asks;
+    std::vector<BookLevel> venueLevels;  // scratch for syncVenue, reused to avoid allocating
+    std::vector<LevelUpdate> pending;
+};
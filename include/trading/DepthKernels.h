@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include "Order.h"
+
+// Scans over one side of a book stored as best-first price and volume
+// columns. Each uses AVX2 on CPUs that have it and a scalar loop otherwise.
+
+// out[i] = volumes[0] + ... + volumes[i]
+void cumulativeVolume(const Quantity* volumes, size_t n, Quantity* out);
+
+// Index of the first level at which the running volume reaches size, or n
+// if the whole side is smaller than size
+size_t levelReachingSize(const Quantity* volumes, size_t n, Quantity size);
+
+// Total volume of the leading levels priced at limit or better: at or above
+// limit for bids, at or below it for asks
+Quantity volumeWithin(const Price* prices, const Quantity* volumes, size_t n, Side side, Price limit);
+
+// Whether the AVX2 versions are in use on this CPU
+bool depthKernelsUseAvx2();
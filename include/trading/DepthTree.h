@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+#include "Order.h"
+
+// Fenwick trees over the slots of one ladder window, holding each slot's
+// volume, volume x slot index and whether it holds a non-empty level. Point updates and best-first prefix
+// searches are O(log slots). Weighting by slot index rather than price keeps
+// the notional sums small and exact: a slot's price is the window's first
+// price plus or minus its index.
+class DepthTree {
+public:
+    static constexpr std::uint64_t NO_LAYOUT = UINT64_MAX;
+
+    explicit DepthTree(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // Ladder layout the tree was built for; NO_LAYOUT until the first build
+    std::uint64_t layout = NO_LAYOUT;
+
+    // Rebuilds in O(slots): reset, seed every occupied slot once, then finish
+    void reset(size_t slots);
+
+    void seed(size_t slot, Quantity volume);
+
+    void finish();
+
+    // levels is +1 when the slot's level becomes non-empty, -1 when it empties
+    void add(size_t slot, Quantity volume, int levels);
+
+    // A best-first run of slots
+    struct Prefix {
+        size_t slots;      // slots in the run
+        size_t levels;     // non-empty levels among them
+        Quantity volume;
+        Quantity weighted; // sum of volume x slot index
+    };
+
+    // Longest run whose combined volume stays below size; the next slot completes it
+    Prefix below(Quantity size) const;
+
+    // Longest run holding at most levels non-empty levels
+    Prefix first(size_t levels) const;
+
+private:
+    template <typename Keep>
+    Prefix descend(Keep&& keep) const;
+
+    std::pmr::vector<Quantity> volumes;  // 1-based Fenwick arrays
+    std::pmr::vector<Quantity> weighted;
+    std::pmr::vector<std::uint32_t> counts;
+    size_t topStep = 0; // highest power of two <= slots
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "Order.h"
+
+// A trade between the best bid and best ask of a crossed book
+struct Fill {
+    Price bidPrice;
+    Price askPrice;
+    Quantity volume;
+    Side aggressor; // side whose order crossed the spread
+    OrderId bidOrderId = 0; // L3 books only
+    OrderId askOrderId = 0;
+
+    // Trades happen at the resting order's price
+    Price tradePrice() const { return aggressor == Side::Bid ? askPrice : bidPrice; }
+};
+
+// Caller-owned fill buffer. clear() keeps the capacity, so reusing one sink
+// across matches does not allocate once it has grown to the largest sweep.
+class FillSink {
+public:
+    void push(const Fill& fill) { fills.push_back(fill); }
+
+    void clear() { fills.clear(); }
+
+    void reserve(size_t n) { fills.reserve(n); }
+
+    size_t size() const { return fills.size(); }
+
+    bool empty() const { return fills.empty(); }
+
+    const Fill& operator[](size_t i) const { return fills[i]; }
+
+    std::vector<Fill>::const_iterator begin() const { return fills.begin(); }
+
+    std::vector<Fill>::const_iterator end() const { return fills.end(); }
+
+private:
+    std::vector<Fill> fills;
+};
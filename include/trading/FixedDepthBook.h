@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include "Order.h"
+#include "PriceLevel.h"
+
+// Top-of-book for feeds that only publish the best few levels: Depth sorted
+// levels per side kept inline in std::arrays, best first, so a whole book is
+// a few cache lines with no heap storage. Every loop runs exactly Depth times
+// (unused slots hold the worst possible price) so insert, shift and truncate
+// unroll into straight-line compares and moves.
+//
+// PriceT is the stored tick type; a narrower one (e.g. std::int32_t) shrinks
+// the book further when the instrument's tick range allows it. Prices that do
+// not fit are refused rather than wrapped; PriceT's two extremes are reserved
+// for empty slots.
+template <size_t Depth, typename PriceT = Price>
+class alignas(64) FixedDepthBook {
+    static_assert(Depth > 0, "FixedDepthBook needs at least one level per side");
+    static_assert(std::is_integral_v<PriceT> && std::is_signed_v<PriceT>, "prices are signed integer ticks");
+
+public:
+    static constexpr size_t DEPTH = Depth;
+
+    FixedDepthBook() { clear(); }
+
+    void clear() {
+        reset<Side::Bid>(bids);
+        reset<Side::Ask>(asks);
+    }
+
+    // Absolute level change: the level at price now holds volume, 0 removes
+    // it. Levels outside the best Depth are dropped. False, with the book
+    // unchanged, if price does not fit PriceT.
+    bool applyUpdate(Side side, Price price, Quantity volume) {
+        if (!fits(price)) return false;
+        if (side == Side::Bid) {
+            place<Side::Bid>(bids, static_cast<PriceT>(price), volume, false);
+        } else {
+            place<Side::Ask>(asks, static_cast<PriceT>(price), volume, false);
+        }
+        return true;
+    }
+
+    // Replaces both sides with the best Depth levels of a snapshot given in
+    // any order; repeated prices are summed. False if any level was skipped
+    // because its price does not fit PriceT.
+    bool setOrderBook(const std::vector<Order>& newBids, const std::vector<Order>& newAsks) {
+        bool complete = true;
+        reset<Side::Bid>(bids);
+        for (const auto& level : newBids) {
+            if (!fits(level.price)) {
+                complete = false;
+                continue;
+            }
+            place<Side::Bid>(bids, static_cast<PriceT>(level.price), level.volume, true);
+        }
+        reset<Side::Ask>(asks);
+        for (const auto& level : newAsks) {
+            if (!fits(level.price)) {
+                complete = false;
+                continue;
+            }
+            place<Side::Ask>(asks, static_cast<PriceT>(level.price), level.volume, true);
+        }
+        return complete;
+    }
+
+    Price bestBid() const { return bids.count ? static_cast<Price>(bids.prices[0]) : -1; }
+
+    Price bestAsk() const { return asks.count ? static_cast<Price>(asks.prices[0]) : -1; }
+
+    size_t bidCount() const { return bids.count; }
+
+    size_t askCount() const { return asks.count; }
+
+    // Copies up to n best levels into out and returns how many were written
+    size_t topBids(size_t n, BookLevel* out) const { return copyTop(bids, n, out); }
+
+    size_t topAsks(size_t n, BookLevel* out) const { return copyTop(asks, n, out); }
+
+    // Calls visitor(price, volume) for every level, best first
+    template <typename Visitor>
+    void forEachBid(Visitor&& visitor) const {
+        for (size_t i = 0; i < bids.count; ++i) visitor(static_cast<Price>(bids.prices[i]), bids.volumes[i]);
+    }
+
+    template <typename Visitor>
+    void forEachAsk(Visitor&& visitor) const {
+        for (size_t i = 0; i < asks.count; ++i) visitor(static_cast<Price>(asks.prices[i]), asks.volumes[i]);
+    }
+
+private:
+    struct Levels {
+        std::array<PriceT, Depth> prices;
+        std::array<Quantity, Depth> volumes;
+        std::uint32_t count;
+    };
+
+    // Whether price can be stored as PriceT without wrapping or colliding with worst()
+    static constexpr bool fits(Price price) {
+        return price > static_cast<Price>(std::numeric_limits<PriceT>::min())
+            && price < static_cast<Price>(std::numeric_limits<PriceT>::max());
+    }
+
+    template <Side S>
+    static constexpr PriceT worst() {
+        return S == Side::Bid ? std::numeric_limits<PriceT>::min() : std::numeric_limits<PriceT>::max();
+    }
+
+    template <Side S>
+    static constexpr bool better(PriceT a, PriceT b) {
+        return S == Side::Bid ? a > b : a < b;
+    }
+
+    template <Side S>
+    static void reset(Levels& levels) {
+        levels.prices.fill(worst<S>());
+        levels.volumes.fill(0);
+        levels.count = 0;
+    }
+
+    // Sets (or with add, increases) the level at price, keeping the side sorted
+    template <Side S>
+    static void place(Levels& levels, PriceT price, Quantity volume, bool add) {
+        size_t position = 0; // levels strictly better than price
+        bool found = false;
+        for (size_t i = 0; i < Depth; ++i) {
+            position += better<S>(levels.prices[i], price);
+            found |= levels.prices[i] == price;
+        }
+
+        if (found) {
+            Quantity updated = add ? levels.volumes[position] + volume : volume;
+            if (updated != 0) {
+                levels.volumes[position] = updated;
+                return;
+            }
+            Levels before = levels;
+            for (size_t i = 0; i + 1 < Depth; ++i) {
+                levels.prices[i] = i >= position ? before.prices[i + 1] : before.prices[i];
+                levels.volumes[i] = i >= position ? before.volumes[i + 1] : before.volumes[i];
+            }
+            levels.prices[Depth - 1] = worst<S>();
+            levels.volumes[Depth - 1] = 0;
+            --levels.count;
+            return;
+        }
+
+        if (volume == 0 || position == Depth) return;
+        Levels before = levels;
+        for (size_t i = 1; i < Depth; ++i) {
+            levels.prices[i] = i > position ? before.prices[i - 1] : before.prices[i];
+            levels.volumes[i] = i > position ? before.volumes[i - 1] : before.volumes[i];
+        }
+        levels.prices[position] = price;
+        levels.volumes[position] = volume;
+        levels.count = static_cast<std::uint32_t>(std::min<size_t>(levels.count + 1, Depth));
+    }
+
+    static size_t copyTop(const Levels& levels, size_t n, BookLevel* out) {
+        n = std::min<size_t>(n, levels.count);
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = {static_cast<Price>(levels.prices[i]), levels.volumes[i], 1};
+        }
+        return n;
+    }
+
+    Levels bids;
+    Levels asks;
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "Order.h"
+
+// Tick and lot size of an instrument, used to convert feed/API decimals
+// to and from the integer prices and sizes stored in OrderBook.
+struct InstrumentSpec {
+    double tickSize;
+    double lotSize;
+
+    Price toTicks(double price) const { return std::llround(price / tickSize); }
+
+    Quantity toLots(double volume) const { return std::llround(volume / lotSize); }
+
+    double fromTicks(Price ticks) const { return static_cast<double>(ticks) * tickSize; }
+
+    double fromLots(Quantity lots) const { return static_cast<double>(lots) * lotSize; }
+};
+
+// Dense per-process instrument number handed out by InstrumentRegistry
+using InstrumentId = std::uint32_t;
+
+constexpr InstrumentId NO_INSTRUMENT = UINT32_MAX;
+
+// Returns the spec for a symbol, or a default 1e-8 tick/lot spec for unknown symbols
+const InstrumentSpec& getInstrumentSpec(const std::string& symbol);
+
+// Levels per side kept for each instrument, fixed at build time so a
+// FixedDepthBook<bookDepth("btcusd")> is sized for its symbol
+constexpr size_t DEFAULT_BOOK_DEPTH = 10;
+
+struct BookDepthSetting {
+    std::string_view symbol;
+    size_t depth;
+};
+
+constexpr BookDepthSetting BOOK_DEPTHS[] = {
+    {"btcusd", 20},
+    {"ethusd", 20},
+};
+
+constexpr size_t bookDepth(std::string_view symbol) {
+    for (const auto& setting : BOOK_DEPTHS) {
+        if (setting.symbol == symbol) return setting.depth;
+    }
+    return DEFAULT_BOOK_DEPTH;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Instrument.h"
+
+// Interns symbols to dense ids and keeps one Entry per instrument in a
+// contiguous array indexed by id. Registration is serialised and meant to
+// happen at subscription time; find, contains, name and operator[] take no
+// lock and are safe to call while another thread registers. Entries are
+// never removed, so ids and references to entries stay valid for the
+// registry's lifetime.
+template <typename Entry>
+class InstrumentRegistry {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 256;
+
+    explicit InstrumentRegistry(size_t capacity = DEFAULT_CAPACITY) : slots(capacity), buckets(tableSize(capacity)) {
+        for (auto& bucket : buckets) bucket.store(0, std::memory_order_relaxed);
+    }
+
+    InstrumentRegistry(const InstrumentRegistry&) = delete;
+    InstrumentRegistry& operator=(const InstrumentRegistry&) = delete;
+
+    // Id of symbol, registering it with a default-constructed entry on first
+    // use; NO_INSTRUMENT if the registry is full
+    InstrumentId intern(std::string_view symbol) {
+        std::lock_guard<std::mutex> lock(registration);
+        InstrumentId id = find(symbol);
+        if (id != NO_INSTRUMENT) return id;
+
+        size_t next = count.load(std::memory_order_relaxed);
+        if (next == slots.size()) return NO_INSTRUMENT;
+
+        // Fill the slot completely before its id becomes reachable
+        slots[next].symbol = symbol;
+        slots[next].entry.emplace();
+        size_t mask = buckets.size() - 1;
+        size_t bucket = std::hash<std::string_view>()(symbol) & mask;
+        while (buckets[bucket].load(std::memory_order_relaxed) != 0) bucket = (bucket + 1) & mask;
+        buckets[bucket].store(static_cast<std::uint32_t>(next + 1), std::memory_order_release);
+        count.store(next + 1, std::memory_order_release);
+        return static_cast<InstrumentId>(next);
+    }
+
+    // NO_INSTRUMENT if symbol was never registered
+    InstrumentId find(std::string_view symbol) const {
+        size_t mask = buckets.size() - 1;
+        for (size_t bucket = std::hash<std::string_view>()(symbol) & mask;; bucket = (bucket + 1) & mask) {
+            std::uint32_t stored = buckets[bucket].load(std::memory_order_acquire); // id + 1, 0 if empty
+            if (stored == 0) return NO_INSTRUMENT;
+            if (slots[stored - 1].symbol == symbol) return stored - 1;
+        }
+    }
+
+    bool contains(std::string_view symbol) const { return find(symbol) != NO_INSTRUMENT; }
+
+    // Ids run from 0 to size() - 1 in registration order
+    size_t size() const { return count.load(std::memory_order_acquire); }
+
+    size_t capacity() const { return slots.size(); }
+
+    // id must have come from intern or find
+    Entry& operator[](InstrumentId id) { return *slots[id].entry; }
+
+    const Entry& operator[](InstrumentId id) const { return *slots[id].entry; }
+
+    const std::string& name(InstrumentId id) const { return slots[id].symbol; }
+
+private:
+    struct Slot {
+        std::string symbol;
+        std::optional<Entry> entry; // constructed in place on registration, never moved
+    };
+
+    // At least twice the capacity so linear probes stay short and always end
+    static size_t tableSize(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity * 2) size *= 2;
+        return size;
+    }
+
+    std::vector<Slot> slots;                          // sized once, never reallocated
+    std::vector<std::atomic<std::uint32_t>> buckets;  // symbol hash -> id + 1
+    std::atomic<size_t> count{0};
+    std::mutex registration;
+};
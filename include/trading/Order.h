@@ -1,8 +1,20 @@
 #pragma once
 
+#include <cstdint>
+
+// Prices are integer ticks and sizes integer lots of the instrument
+// (see InstrumentSpec); conversion to decimals only happens at the edges.
+using Price = std::int64_t;
+using Quantity = std::int64_t;
+
+using OrderId = std::uint64_t; // 0 means no id (L2 levels)
+
+enum class Side { Bid, Ask };
+
 struct Order {
-    double price;
-    double volume;
+    Price price;
+    Quantity volume;
+    OrderId id;
 
-    Order(double p, double v);
-};
\ No newline at end of file
+    Order(Price p, Quantity v, OrderId i = 0);
+};
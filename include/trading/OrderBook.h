@@ -1,29 +1,290 @@
 #pragma once
 
-#include <map>
-#include <deque>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "BookArena.h"
+#include "DepthTree.h"
+#include "Fill.h"
 #include "Order.h"
-#include <json.hpp>
+#include "OrderIndex.h"
+#include "OrderRequest.h"
+#include "PriceLadder.h"
+#include "PriceLevel.h"
+
+// Absolute L2 level change: the level at price now holds volume, 0 removes it
+struct LevelUpdate {
+    Side side;
+    Price price;
+    Quantity volume;
+};
+
+using LevelIterator = PriceLadder<PriceLevel>::const_iterator;
+
+// Best-first range of levels read in place; valid until the book is modified
+struct LevelRange {
+    LevelIterator first;
+    LevelIterator last;
+
+    LevelIterator begin() const { return first; }
+    LevelIterator end() const { return last; }
+};
+
+// What a book holds and what has been done to it. Counts belong to the
+// book object: a copy starts from zero and assignment keeps the target's.
+struct BookStats {
+    size_t bidLevels = 0;
+    size_t askLevels = 0;
+    size_t maxBidLevels = 0;        // deepest each side has been
+    size_t maxAskLevels = 0;
+    size_t restingOrders = 0;       // BookMode::L3 only
+    std::uint64_t levelUpdates = 0; // applyUpdate calls
+    std::uint64_t snapshots = 0;    // setOrderBook calls
+    std::uint64_t orderEvents = 0;  // L3 adds, cancels, reductions, replaces and submits
+    std::uint64_t fills = 0;        // from match, matchOrders and submit
+    AllocationStats memory;         // the book's arena
+
+    std::uint64_t operations() const { return levelUpdates + snapshots + orderEvents; }
+};
+
+enum class BookMode {
+    L3, // every order has an id and is kept in time priority within its level
+    L2  // levels only hold aggregate volume and order count
+};
 
 class OrderBook {
 public:
-    void addBid(double price, double volume);
+    explicit OrderBook(BookMode mode = BookMode::L3);
+
+    // Copies draw from a fresh arena; assignment keeps this book's arena
+    OrderBook(const OrderBook& other);
+    OrderBook(OrderBook&& other) = default;
+    OrderBook& operator=(const OrderBook& other);
+    OrderBook& operator=(OrderBook&& other);
+
+    BookMode getMode() const { return mode; }
+
+    // Returns the id assigned to the order in L3 mode, 0 in L2 mode or if
+    // volume is not positive
+    OrderId addBid(Price price, Quantity volume);
+
+    OrderId addAsk(Price price, Quantity volume);
+
+    // L3 only: adds an order under a caller-chosen id (e.g. an exchange order
+    // id). False if the id is already resting, volume is not positive or the
+    // book is L2.
+    bool addOrder(OrderId id, Side side, Price price, Quantity volume);
+
+    bool cancelOrder(OrderId id);
+
+    // Takes volume off an order without losing its queue position; an order
+    // reduced to nothing is cancelled. False for a volume that is not positive.
+    bool reduceOrder(OrderId id, Quantity volume);
 
-    void addAsk(double price, double volume);
+    // Moves an order to a new price and volume. A same-price size decrease
+    // keeps queue priority, anything else goes to the back of the queue.
+    bool replaceOrder(OrderId id, Price price, Quantity volume);
 
-    double bestBid() const;
+    // nullptr if the id is not resting; valid until the book is modified
+    const RestingOrder* findOrder(OrderId id) const;
 
-    double bestAsk() const;
+    // Number of price levels on a side
+    size_t levelCount(Side side) const { return side == Side::Bid ? bids.size() : asks.size(); }
 
+    Price bestBid() const; // -1 if there are no bids
+
+    Price bestAsk() const; // -1 if there are no asks
+
+    // Performs a single match between the best bid and ask; false if the book is not crossed
     bool matchOrders();
 
-    void setOrderBook(const nlohmann::json& json);
+    // Uncrosses the whole book in one sweep, appending every fill to sink.
+    // Returns the number of fills.
+    size_t match(FillSink& sink);
+
+    // Matches an incoming order against resting liquidity in price-time
+    // priority, appending its fills to sink, then rests or drops the
+    // remainder according to its type
+    SubmitResult submit(const OrderRequest& request, FillSink& sink);
+
+    void applyUpdate(Side side, Price price, Quantity volume);
+
+    void applyBatch(const std::vector<LevelUpdate>& updates);
 
+    // Replaces the book with a snapshot. Levels sorted best first are diffed
+    // against the current book so only changed levels are touched. Entries
+    // whose volume is not positive are ignored.
+    void setOrderBook(const std::vector<Order>& newBids, const std::vector<Order>& newAsks);
+
+    // One entry per order, or per level in L2 mode, best price first
     std::vector<Order> getBids() const;
     
     std::vector<Order> getAsks() const;
 
+    // Copies up to n best levels into out and returns how many were written
+    size_t topBids(size_t n, BookLevel* out) const;
+
+    size_t topAsks(size_t n, BookLevel* out) const;
+
+    // Calls visitor(const PriceLevel&) for up to maxLevels levels, best first
+    template <typename Visitor>
+    void forEachBid(Visitor&& visitor, size_t maxLevels = std::numeric_limits<size_t>::max()) const {
+        bids.forEach([&visitor](Price, const PriceLevel& level) { visitor(level); }, maxLevels);
+    }
+
+    template <typename Visitor>
+    void forEachAsk(Visitor&& visitor, size_t maxLevels = std::numeric_limits<size_t>::max()) const {
+        asks.forEach([&visitor](Price, const PriceLevel& level) { visitor(level); }, maxLevels);
+    }
+
+    // Running volume totals of up to n best levels written to out; returns
+    // how many were written
+    size_t cumulativeDepth(Side side, size_t n, Quantity* out) const;
+
+    // Price of the level at which sweeping size would complete, -1 if the
+    // side does not hold that much
+    Price priceForSize(Side side, Quantity size) const;
+
+    // Volume resting within bps basis points of the mid; 0 without a two-sided book
+    Quantity depthWithinBps(Side side, double bps) const;
+
+    // Notional (ticks x lots) of sweeping size off a side of the book, -1 if
+    // the side does not hold that much. O(log levels) while the sweep stays
+    // inside the ladder window.
+    double costToFill(Side side, Quantity size) const;
+
+    // Average price in ticks of sweeping size, -1 if the side does not hold that much
+    double vwapForSize(Side side, Quantity size) const;
+
+    // Microstructure signals, in ticks. The best-level ones are O(1); the
+    // multi-level ones read the depth trees in O(log levels) and none of
+    // them allocate. Prices are -1 without a two-sided book.
+    double mid() const;
+
+    // Mid weighted by the opposite side's best size
+    double microprice() const;
+
+    // microprice() over each side's volume-weighted price of its best levels levels
+    double weightedMid(size_t levels) const;
+
+    // (bid - ask) / (bid + ask) volume over each side's best levels levels, 0 if both are empty
+    double imbalance(size_t levels) const;
+
+    // Spread as a fraction of mid in basis points, -1 without a two-sided book
+    double spreadBps() const;
+
+    // Order-independent hash of every level's side, price and volume, kept
+    // current in O(1) per level change. Books holding the same levels have
+    // the same checksum whatever sequence of updates built them.
+    std::uint64_t checksum() const { return bidChecksum ^ askChecksum; }
+
+    // The same hash computed from scratch, for verifying checksum()
+    std::uint64_t recomputeChecksum() const;
+
+    LevelRange bidLevels() const { return {bids.begin(), bids.end()}; }
+
+    LevelRange askLevels() const { return {asks.begin(), asks.end()}; }
+
+    AllocationStats getAllocationStats() const { return arena->stats(); }
+
+    BookStats stats() const;
+
 private:
-    std::map<double, std::deque<Order>> bids; // price -> list of orders (buy)
-    std::map<double, std::deque<Order>> asks; // price -> list of orders (sell)
+    using Ladder = PriceLadder<PriceLevel>;
+
+    // One side's levels as best-first price and volume arrays for the depth
+    // kernels, rebuilt on the first depth query after the side changes
+    struct DepthColumns {
+        explicit DepthColumns(std::pmr::memory_resource* resource) : prices(resource), volumes(resource) {}
+
+        std::pmr::vector<Price> prices;
+        std::pmr::vector<Quantity> volumes;
+        std::uint64_t version = UINT64_MAX; // ladder version the columns reflect
+    };
+
+    // Ids handed out by addBid/addAsk/submit start here, clear of typical exchange ids
+    static constexpr OrderId FIRST_ASSIGNED_ID = OrderId(1) << 63;
+
+    Ladder& ladderFor(Side side) { return side == Side::Bid ? bids : asks; }
+
+    OrderId assignId();
+
+    OrderId addToLevel(Side side, Price price, Quantity volume, OrderId id);
+
+    void linkOrder(PriceLevel& level, Side side, OrderId id, Price price, Quantity volume);
+
+    void unlinkOrder(PriceLevel& level, std::uint32_t slot);
+
+    void releaseOrders(std::uint32_t head);
+
+    void setLevelVolume(Ladder& ladder, PriceLevel& level, Quantity volume);
+
+    void eraseLevel(Ladder& ladder, Price price);
+
+    void clearSide(Ladder& ladder);
+
+    Quantity frontVolume(const PriceLevel& level, Quantity traded) const;
+
+    bool matchOnce(Fill& fill);
+
+    OrderId takeFront(PriceLevel& level, Quantity volume);
+
+    void settleLevel(Ladder& ladder, PriceLevel& level, Quantity traded);
+
+    void noteAggressor(Side side, Price price);
+
+    Quantity liquidityUpTo(const Ladder& resting, const OrderRequest& request) const;
+
+    void syncSide(Ladder& ladder, const std::vector<Order>& levels);
+
+    std::vector<Order> collect(const Ladder& ladder) const;
+
+    static size_t copyTop(const Ladder& ladder, size_t n, BookLevel* out);
+
+    const DepthColumns& depthColumns(Side side) const;
+
+    const DepthTree& depthTree(Side side) const;
+
+    struct TopDepth {
+        Quantity volume;
+        double notional; // ticks x lots
+    };
+
+    // Last topDepth answer for one side, so signals read together share it
+    struct TopDepthMemo {
+        std::uint64_t version = UINT64_MAX; // ladder version it was computed at
+        size_t levels = 0;
+        TopDepth top{0, 0};
+    };
+
+    TopDepth topDepth(Side side, size_t levels) const;
+
+    // Records the deepest each side has been; called wherever levels can be added
+    void noteDepth() {
+        counters.maxBidLevels = std::max(counters.maxBidLevels, bids.size());
+        counters.maxAskLevels = std::max(counters.maxAskLevels, asks.size());
+    }
+
+    BookMode mode;
+    Side aggressor = Side::Bid; // side of the last order that crossed the spread
+    OrderId nextOrderId = FIRST_ASSIGNED_ID;
+    std::uint32_t freeOrders = NO_ORDER; // free list through RestingOrder::next
+    std::unique_ptr<BookArena> arena; // declared before the containers that draw from it
+    Ladder bids; // price -> level (buy)
+    Ladder asks; // price -> level (sell)
+    std::pmr::vector<RestingOrder> orderPool; // L3 orders, linked per level
+    OrderIndex orderIndex;                    // order id -> orderPool slot
+    std::pmr::vector<Price> staleLevels; // scratch for setOrderBook, reused to avoid allocating
+    mutable DepthColumns bidColumns;
+    mutable DepthColumns askColumns;
+    mutable DepthTree bidTree; // kept in step by setLevelVolume, rebuilt when the window moves
+    mutable DepthTree askTree;
+    mutable TopDepthMemo bidTop;
+    mutable TopDepthMemo askTop;
+    std::uint64_t bidChecksum = 0; // XOR of levelHash over each side's levels
+    std::uint64_t askChecksum = 0;
+    BookStats counters; // operation counts and depth high-water marks; filled in by stats()
 };
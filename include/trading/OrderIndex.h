@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+#include "Order.h"
+
+// Open-addressing map from order id to the order's slot in a book's order
+// pool. Linear probing over a power-of-two table with backward-shift
+// deletion, so lookups never wade through tombstones.
+class OrderIndex {
+public:
+    static constexpr std::uint32_t NONE = UINT32_MAX;
+
+    explicit OrderIndex(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // Copies other into storage drawn from resource
+    OrderIndex(const OrderIndex& other, std::pmr::memory_resource* resource);
+
+    OrderIndex(const OrderIndex&) = default;
+    OrderIndex(OrderIndex&&) = default;
+    OrderIndex& operator=(const OrderIndex&) = default;
+    OrderIndex& operator=(OrderIndex&&) = default;
+
+    // Slot of id, or NONE
+    std::uint32_t find(OrderId id) const;
+
+    // False if id is already present
+    bool insert(OrderId id, std::uint32_t slot);
+
+    bool erase(OrderId id);
+
+    void clear();
+
+    size_t size() const { return count; }
+
+private:
+    struct Entry {
+        OrderId id = 0;
+        std::uint32_t slot = NONE; // NONE marks an empty bucket
+    };
+
+    size_t home(OrderId id) const;
+
+    void grow();
+
+    std::pmr::vector<Entry> entries;
+    size_t mask;
+    size_t count = 0;
+};
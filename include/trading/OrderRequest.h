@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Order.h"
+
+enum class OrderType {
+    Limit,             // trades up to price, remainder rests
+    Market,            // trades at any price, remainder is cancelled
+    ImmediateOrCancel, // trades up to price, remainder is cancelled
+    FillOrKill,        // trades its full volume up to price or not at all
+    PostOnly           // rests at price, rejected if it would trade
+};
+
+struct OrderRequest {
+    Side side;
+    OrderType type;
+    Price price;       // ignored for market orders
+    Quantity volume;
+    OrderId id = 0;    // L3 books: id to rest under, 0 to have one assigned
+};
+
+enum class OrderStatus {
+    Filled,    // fully executed
+    Resting,   // the unfilled remainder was added to the book
+    Cancelled, // the unfilled remainder was dropped (IOC, market, killed FOK)
+    Rejected   // invalid request, duplicate id, or a post-only order that would cross
+};
+
+struct SubmitResult {
+    OrderStatus status;
+    Quantity filled;
+    Quantity remaining;
+    OrderId id;        // id the order traded and, if resting, rests under
+};
@@ -0,0 +1,333 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+#include "Order.h"
+
+// One side of a book as a contiguous, tick-indexed array of levels around the
+// best price, with an occupancy bitmap so best/next-level lookups are a
+// find-first-set instead of a tree walk.
+//
+// Prices are stored as keys ordered best-first (bids are negated), so slot 0
+// is the best possible price in the window for both sides. Levels that fall
+// behind the window live in a sorted overflow map; every overflow key is worse
+// than every window key, so the best level is always in the window when the
+// side is not empty. Overflow nodes are kept for reuse when their level goes
+// away, so the side only allocates once it holds more levels behind the
+// window than it ever has before.
+//
+// All storage comes from the memory resource given at construction, which
+// levels also receive if they are allocator-aware.
+template <typename Level>
+class PriceLadder {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 2048;
+
+    explicit PriceLadder(Side side,
+                         std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+                         size_t capacity = DEFAULT_CAPACITY)
+        : side(side), capacity((capacity + 63) / 64 * 64),
+          slots(this->capacity, resource), occupied(this->capacity / 64, 0, resource), overflow(resource),
+          spare(resource), moved(resource) {}
+
+    // Copies other into storage drawn from resource
+    PriceLadder(const PriceLadder& other, std::pmr::memory_resource* resource)
+        : side(other.side), capacity(other.capacity), base(other.base), bestIndex(other.bestIndex), count(other.count),
+          changes(other.changes), moves(other.moves),
+          slots(other.slots, resource), occupied(other.occupied, resource), overflow(other.overflow, resource),
+          spare(resource), moved(resource) {}
+
+    PriceLadder(const PriceLadder&) = default;
+    PriceLadder(PriceLadder&&) = default;
+    PriceLadder& operator=(const PriceLadder&) = default;
+    PriceLadder& operator=(PriceLadder&&) = default;
+
+    bool empty() const { return count == 0; }
+
+    size_t size() const { return count + overflow.size(); }
+
+    // Changes whenever a level may have been added, removed or handed out for
+    // writing, so readers can tell whether anything they derived is stale
+    std::uint64_t version() const { return changes; }
+
+    // Structures indexed by window slot stay valid until layout() changes:
+    // slot i holds the level at slotPrice(i) until the window moves or the
+    // side is cleared
+    std::uint64_t layout() const { return moves; }
+
+    size_t windowSize() const { return capacity; }
+
+    // windowSize() if price falls outside the window
+    size_t slotOf(Price price) const {
+        Price key = toKey(price);
+        return inWindow(key) ? static_cast<size_t>(key - base) : capacity;
+    }
+
+    Price slotPrice(size_t slot) const { return toPrice(base + static_cast<Price>(slot)); }
+
+    // -1 if the side is empty
+    Price bestPrice() const { return count == 0 ? -1 : toPrice(base + static_cast<Price>(bestIndex)); }
+
+    Level& best() {
+        ++changes;
+        return slots[bestIndex];
+    }
+
+    const Level& best() const { return slots[bestIndex]; }
+
+    Level* find(Price price) {
+        ++changes;
+        return locate(price);
+    }
+
+    const Level* find(Price price) const { return const_cast<PriceLadder*>(this)->locate(price); }
+
+    // Returns the level at price, creating an empty one if needed
+    Level& insert(Price price) {
+        ++changes;
+        Price key = toKey(price);
+        if (!inWindow(key)) {
+            if (count == 0 || key < base) {
+                recenter(key); // empty side or a new best outside the window
+            } else if (bestIndex > capacity / 2 + capacity / 4) {
+                recenter(base + static_cast<Price>(bestIndex)); // market moved away from the window centre
+            }
+            if (!inWindow(key)) {
+                return insertOverflow(key);
+            }
+        }
+        size_t index = static_cast<size_t>(key - base);
+        if (!isOccupied(index)) {
+            occupied[index / 64] |= bit(index);
+            if (count == 0 || index < bestIndex) bestIndex = index;
+            ++count;
+        }
+        return slots[index];
+    }
+
+    void erase(Price price) {
+        ++changes;
+        Price key = toKey(price);
+        if (!inWindow(key)) {
+            auto it = overflow.find(key);
+            if (it != overflow.end()) eraseOverflow(it);
+            return;
+        }
+        size_t index = static_cast<size_t>(key - base);
+        if (!isOccupied(index)) return;
+
+        occupied[index / 64] &= ~bit(index);
+        resetLevel(slots[index], 0);
+        --count;
+
+        if (count == 0) {
+            if (!overflow.empty()) recenter(overflow.begin()->first);
+        } else if (index == bestIndex) {
+            bestIndex = nextOccupied(index + 1);
+        }
+    }
+
+    void clear() {
+        ++changes;
+        ++moves;
+        for (size_t index = count ? bestIndex : capacity; index < capacity; index = nextOccupied(index + 1)) {
+            resetLevel(slots[index], 0);
+        }
+        std::fill(occupied.begin(), occupied.end(), 0);
+        while (!overflow.empty()) eraseOverflow(overflow.begin());
+        count = 0;
+    }
+
+    // Calls fn(price, level) for up to maxLevels levels, best price first
+    template <typename Fn>
+    void forEach(Fn&& fn, size_t maxLevels = std::numeric_limits<size_t>::max()) const {
+        // Walks each bitmap word's set bits locally rather than re-searching
+        // from every slot, which keeps the loop off the load-shift-ctz chain
+        for (size_t word = count ? bestIndex / 64 : occupied.size(); maxLevels > 0 && word < occupied.size(); ++word) {
+            for (uint64_t bits = occupied[word]; bits != 0 && maxLevels > 0; bits &= bits - 1, --maxLevels) {
+                size_t index = word * 64 + static_cast<size_t>(__builtin_ctzll(bits));
+                fn(toPrice(base + static_cast<Price>(index)), slots[index]);
+            }
+        }
+        for (auto it = overflow.begin(); maxLevels > 0 && it != overflow.end(); ++it, --maxLevels) {
+            fn(toPrice(it->first), it->second);
+        }
+    }
+
+    // Calls fn(price, level) for the levels behind the window, best price first
+    template <typename Fn>
+    void forEachOverflow(Fn&& fn) const {
+        for (const auto& [key, level] : overflow) {
+            fn(toPrice(key), level);
+        }
+    }
+
+    // Best-first forward iterator over the levels, reading them in place
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Level;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Level*;
+        using reference = const Level&;
+
+        const_iterator() = default;
+
+        reference operator*() const { return index < ladder->capacity ? ladder->slots[index] : overflowIt->second; }
+
+        pointer operator->() const { return &**this; }
+
+        Price price() const {
+            return ladder->toPrice(index < ladder->capacity ? ladder->base + static_cast<Price>(index) : overflowIt->first);
+        }
+
+        const_iterator& operator++() {
+            if (index < ladder->capacity) {
+                index = ladder->nextOccupied(index + 1);
+            } else {
+                ++overflowIt;
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return index == other.index && (index < ladder->capacity || overflowIt == other.overflowIt);
+        }
+
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+    private:
+        friend class PriceLadder;
+
+        using OverflowIterator = typename std::pmr::map<Price, Level>::const_iterator;
+
+        const_iterator(const PriceLadder* ladder, size_t index, OverflowIterator overflowIt)
+            : ladder(ladder), index(index), overflowIt(overflowIt) {}
+
+        const PriceLadder* ladder = nullptr;
+        size_t index = 0;            // window slot, or capacity once in the overflow levels
+        OverflowIterator overflowIt;
+    };
+
+    const_iterator begin() const { return const_iterator(this, count ? bestIndex : capacity, overflow.begin()); }
+
+    const_iterator end() const { return const_iterator(this, capacity, overflow.end()); }
+
+private:
+    Price toKey(Price price) const { return side == Side::Bid ? -price : price; }
+
+    Price toPrice(Price key) const { return side == Side::Bid ? -key : key; }
+
+    bool inWindow(Price key) const { return key >= base && key < base + static_cast<Price>(capacity); }
+
+    Level* locate(Price price) {
+        Price key = toKey(price);
+        if (inWindow(key)) {
+            size_t index = static_cast<size_t>(key - base);
+            return isOccupied(index) ? &slots[index] : nullptr;
+        }
+        auto it = overflow.find(key);
+        return it != overflow.end() ? &it->second : nullptr;
+    }
+
+    // Empties a slot but keeps any storage the level owns, so re-occupying it does not allocate
+    template <typename L>
+    static auto resetLevel(L& level, int) -> decltype(level.clear(), void()) { level.clear(); }
+
+    template <typename L>
+    static void resetLevel(L& level, long) { level = L(); }
+
+    static uint64_t bit(size_t index) { return uint64_t(1) << (index % 64); }
+
+    bool isOccupied(size_t index) const { return occupied[index / 64] & bit(index); }
+
+    // First occupied slot at or after from, or capacity if there is none
+    size_t nextOccupied(size_t from) const {
+        if (from >= capacity) return capacity;
+        size_t word = from / 64;
+        uint64_t bits = occupied[word] & (~uint64_t(0) << (from % 64));
+        while (bits == 0) {
+            if (++word == occupied.size()) return capacity;
+            bits = occupied[word];
+        }
+        return word * 64 + static_cast<size_t>(__builtin_ctzll(bits));
+    }
+
+    // Moves the window so bestKey sits in its middle. Window levels that no
+    // longer fit go to overflow and overflow levels that now fit come back.
+    void recenter(Price bestKey) {
+        ++moves;
+        moved.clear();
+        moved.reserve(count);
+        for (size_t index = count ? bestIndex : capacity; index < capacity; index = nextOccupied(index + 1)) {
+            moved.emplace_back(base + static_cast<Price>(index), std::move(slots[index]));
+            slots[index] = Level();
+        }
+        std::fill(occupied.begin(), occupied.end(), 0);
+        count = 0;
+
+        base = bestKey - static_cast<Price>(capacity / 2);
+        for (auto& [key, level] : moved) {
+            if (inWindow(key)) {
+                place(key, std::move(level));
+            } else {
+                insertOverflow(key) = std::move(level);
+            }
+        }
+        moved.clear();
+        while (!overflow.empty() && inWindow(overflow.begin()->first)) {
+            place(overflow.begin()->first, std::move(overflow.begin()->second));
+            eraseOverflow(overflow.begin());
+        }
+    }
+
+    // Returns the overflow level at key, creating an empty one in a spare node if there is one
+    Level& insertOverflow(Price key) {
+        auto it = overflow.find(key);
+        if (it != overflow.end()) return it->second;
+        if (spare.empty()) return overflow.try_emplace(key).first->second;
+        auto node = spare.extract(spare.begin());
+        node.key() = key;
+        return overflow.insert(std::move(node)).position->second;
+    }
+
+    void eraseOverflow(typename std::pmr::map<Price, Level>::iterator it) {
+        auto node = overflow.extract(it);
+        resetLevel(node.mapped(), 0);
+        spare.insert(spare.end(), std::move(node));
+    }
+
+    void place(Price key, Level&& level) {
+        size_t index = static_cast<size_t>(key - base);
+        slots[index] = std::move(level);
+        occupied[index / 64] |= bit(index);
+        if (count == 0 || index < bestIndex) bestIndex = index;
+        ++count;
+    }
+
+    Side side;
+    size_t capacity;
+    Price base = 0;          // key of slot 0
+    size_t bestIndex = 0;    // valid while count > 0
+    size_t count = 0;        // occupied window slots
+    std::uint64_t changes = 0;
+    std::uint64_t moves = 0;
+    std::pmr::vector<Level> slots;
+    std::pmr::vector<uint64_t> occupied;
+    std::pmr::map<Price, Level> overflow; // levels worse than the window, best first
+    std::pmr::multimap<Price, Level> spare; // emptied overflow nodes kept for reuse, keys unused
+    std::pmr::vector<std::pair<Price, Level>> moved; // recenter's scratch space
+};
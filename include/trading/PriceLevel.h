@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include "Order.h"
+
+constexpr std::uint32_t NO_ORDER = UINT32_MAX;
+
+// An order resting in an L3 book. Orders live in the book's order pool and
+// are chained per price level through prev/next pool slots.
+struct RestingOrder {
+    OrderId id = 0;
+    Price price = 0;
+    Quantity volume = 0;
+    std::uint32_t prev = NO_ORDER;
+    std::uint32_t next = NO_ORDER;
+    Side side = Side::Bid;
+};
+
+// Plain copy of a level's totals, used to hand levels out without allocating
+struct BookLevel {
+    Price price;
+    Quantity volume;
+    std::uint32_t orderCount;
+};
+
+// One price level of a book. Totals are kept inline for every level; L3
+// books also link the level's orders, oldest first, from head to tail.
+struct PriceLevel {
+    Price price = 0;
+    Quantity volume = 0;         // total resting volume at this price
+    std::uint32_t orderCount = 0;
+    std::uint32_t head = NO_ORDER; // BookMode::L3 only
+    std::uint32_t tail = NO_ORDER;
+
+    void clear() {
+        volume = 0;
+        orderCount = 0;
+        head = NO_ORDER;
+        tail = NO_ORDER;
+    }
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "Instrument.h"
+#include "Order.h"
+
+// One [price, size, ...] entry as sent, before conversion to ticks and lots
+struct FeedLevel {
+    double price;
+    double size;
+};
+
+// The fields of an sFOX message the feed handler acts on. The strings point
+// into the parsed payload and are only valid as long as it is.
+struct SfoxMessage {
+    std::string_view type;
+    std::string_view recipient;  // feed name, e.g. orderbook.sfox.btcusd
+    std::int64_t timestamp = 0;  // ns since epoch, 0 if absent
+    bool hasBids = false;
+    bool hasAsks = false;
+    std::vector<FeedLevel> bids; // in message order
+    std::vector<FeedLevel> asks;
+
+    bool hasBook() const { return hasBids || hasAsks; }
+};
+
+// Single-pass parser for sFOX websocket messages. It walks the payload once,
+// reads the fields above in place and skips everything else without building
+// a DOM. The level vectors are reused, so a warm message does not allocate.
+// Skipped values are only checked for balanced brackets and quotes.
+class SfoxParser {
+public:
+    // False if payload is not a JSON object or a field read is malformed;
+    // message is then partly filled and must not be used
+    static bool parse(std::string_view payload, SfoxMessage& message);
+};
+
+// Converts levels to ticks and lots and writes the best `depth` of them to
+// out, best first. The kept levels are selected before any sorting, so only
+// they get ordered.
+void selectTopLevels(const std::vector<FeedLevel>& levels, Side side, const InstrumentSpec& spec, size_t depth,
+                     std::vector<Order>& out);
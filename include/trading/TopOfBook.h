@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "OrderBook.h"
+#include "PriceLevel.h"
+
+// Best bid and offer of one book at one update
+struct TopOfBook {
+    Price bid = -1;          // -1 if there are no bids
+    Quantity bidQty = 0;
+    Price ask = -1;          // -1 if there are no asks
+    Quantity askQty = 0;
+    std::uint64_t version = 0; // number of updates written, 0 before the first one
+    std::int64_t exchTs = 0;   // exchange timestamp, ns since epoch (0 if the feed has none)
+    std::int64_t recvTs = 0;   // local receive time, ns since epoch
+};
+
+// Single-writer BBO cache behind a seqlock. The writer bumps the sequence to
+// odd, writes the fields and bumps it back to even; a reader copies the
+// fields and retries if the sequence was odd or moved meanwhile. Readers
+// never block the writer and nothing is allocated or copied beyond the
+// record itself, which fills one cache line.
+class alignas(64) TopOfBookCache {
+public:
+    // Writer only
+    void publish(const TopOfBook& top) {
+        std::uint64_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        bid.store(top.bid, std::memory_order_relaxed);
+        bidQty.store(top.bidQty, std::memory_order_relaxed);
+        ask.store(top.ask, std::memory_order_relaxed);
+        askQty.store(top.askQty, std::memory_order_relaxed);
+        exchTs.store(top.exchTs, std::memory_order_relaxed);
+        recvTs.store(top.recvTs, std::memory_order_relaxed);
+
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // Writer only: captures the book's best levels as the next version
+    void publish(const OrderBook& book, std::int64_t exchangeTime, std::int64_t receiveTime) {
+        BookLevel bestBid;
+        BookLevel bestAsk;
+        TopOfBook top;
+        if (book.topBids(1, &bestBid) == 1) {
+            top.bid = bestBid.price;
+            top.bidQty = bestBid.volume;
+        }
+        if (book.topAsks(1, &bestAsk) == 1) {
+            top.ask = bestAsk.price;
+            top.askQty = bestAsk.volume;
+        }
+        top.exchTs = exchangeTime;
+        top.recvTs = receiveTime;
+        publish(top);
+    }
+
+    // Any thread: a consistent copy of the latest record
+    TopOfBook load() const {
+        TopOfBook top;
+        std::uint64_t before;
+        std::uint64_t after;
+        do {
+            before = sequence.load(std::memory_order_acquire);
+            top.bid = bid.load(std::memory_order_relaxed);
+            top.bidQty = bidQty.load(std::memory_order_relaxed);
+            top.ask = ask.load(std::memory_order_relaxed);
+            top.askQty = askQty.load(std::memory_order_relaxed);
+            top.exchTs = exchTs.load(std::memory_order_relaxed);
+            top.recvTs = recvTs.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) != 0 || before != after);
+        top.version = before / 2;
+        return top;
+    }
+
+private:
+    // Fields are relaxed atomics so the optimistic reads are not data races
+    std::atomic<std::uint64_t> sequence{0};
+    std::atomic<Price> bid{-1};
+    std::atomic<Quantity> bidQty{0};
+    std::atomic<Price> ask{-1};
+    std::atomic<Quantity> askQty{0};
+    std::atomic<std::int64_t> exchTs{0};
+    std::atomic<std::int64_t> recvTs{0};
+};
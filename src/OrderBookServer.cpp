@@ -1,10 +1,11 @@
 #include "OrderBookServer.h"
 #include "WebSocketClient.h"  // For access to global orderBooks
-#include "trading/OrderBook.h"
+#include "trading/AsyncLog.h"
+#include "trading/BookSnapshot.h"
 #include "trading/Order.h"
+#include "trading/Instrument.h"
 
 #include <grpcpp/grpcpp.h>
-#include <iostream>
 #include <stdexcept>
 
 using grpc::ServerContext;
@@ -26,38 +27,43 @@ Status OrderBookServer::GetOrderBook(ServerContext* context,
                                      OrderBookResponse* response) {
     std::string symbol = request->symbol();
 
-    // Get order book from global map
-    if (!WebSocketClient::hasOrderBook(symbol)) {
+    // Resolve the symbol once; the lookup takes no lock
+    InstrumentId id = WebSocketClient::findInstrument(symbol);
+    if (id == NO_INSTRUMENT) {
         return Status(StatusCode::NOT_FOUND, "Symbol not found in order books");
     }
 
-    const OrderBook& book = WebSocketClient::getOrderBook(symbol);
-    const auto& bids = book.getBids();
-    const auto& asks = book.getAsks();
+    // Refcounted view of the latest published book; the feed keeps publishing meanwhile
+    std::shared_ptr<const BookSnapshot> snapshot = WebSocketClient::getSnapshot(id);
+    const BookSnapshot& book = *snapshot;
 
-    if (bids.empty() && asks.empty()) {
+    if (book.empty()) {
         return Status(StatusCode::NOT_FOUND, "No order book data available for symbol: " + symbol);
     }
 
-    for (const auto& b : bids) {
+    // The book stores integer ticks/lots; convert back to decimals for the wire
+    const InstrumentSpec& spec = getInstrumentSpec(symbol);
+    auto toPrice = [&spec](Price ticks) { return ticks < 0 ? -1.0 : spec.fromTicks(ticks); };
+
+    // Levels are written straight from the snapshot, without an intermediate copy
+    for (const BookLevel& level : book.getBids()) {
         orderbook::Order* o = response->add_bids();
-        o->set_price(b.price);
-        o->set_volume(b.volume);
+        o->set_price(spec.fromTicks(level.price));
+        o->set_volume(spec.fromLots(level.volume));
     }
 
-    for (const auto& a : asks) {
+    for (const BookLevel& level : book.getAsks()) {
         orderbook::Order* o = response->add_asks();
-        o->set_price(a.price);
-        o->set_volume(a.volume);
+        o->set_price(spec.fromTicks(level.price));
+        o->set_volume(spec.fromLots(level.volume));
     }
 
     response->set_symbol(symbol);
-    response->set_best_bid(book.bestBid());
-    response->set_best_ask(book.bestAsk());
+    response->set_best_bid(toPrice(book.bestBid()));
+    response->set_best_ask(toPrice(book.bestAsk()));
     response->set_timestamp(static_cast<int64_t>(std::time(nullptr)));  // current UNIX time
 
-    std::cout << "📡 Served order book for " << symbol
-              << " | " << bids.size() << " bids, " << asks.size() << " asks\n";
+    LOG_INFO("📡 Served order book for {} | {} bids, {} asks\n", symbol, response->bids_size(), response->asks_size());
 
     return Status::OK;
 }
@@ -72,6 +78,6 @@ Status OrderBookServer::GetAvailableSymbols(ServerContext* context,
         response->add_symbols(sym);
     }
 
-    std::cout << "📡 Served symbol list: " << instruments.size() << " instruments\n";
+    LOG_INFO("📡 Served symbol list: {} instruments\n", instruments.size());
     return Status::OK;
 }
@@ -1,9 +1,16 @@
 #include "WebSocketClient.h"
+#include "trading/AsyncLog.h"
 #include "trading/OrderBook.h"
+#include "trading/BookSnapshot.h"
+#include "trading/Instrument.h"
+#include "trading/InstrumentRegistry.h"
+#include "trading/SfoxParser.h"
+#include "trading/TopOfBook.h"
 #include <websocketpp/config/asio_client.hpp>
 #include <websocketpp/client.hpp>
 
 #include <json.hpp>
+#include <iomanip>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -21,13 +28,8 @@ typedef websocketpp::client<websocketpp::config::asio_tls_client> client;
 typedef websocketpp::config::asio_client::message_type::ptr message_ptr;
 
 std::unordered_map<std::string, std::string> loadConfig(const std::string& path);
-std::mutex output_mutex; // For thread-safe console output
 
-// Global map of instrument -> OrderBook
-std::unordered_map<std::string, OrderBook> global_orderbooks;
-std::mutex orderbook_mutex; // For thread-safe orderbook access
-
-// Timeout tracking - using regular variables instead of atomics in map
+// Timeout tracking - using regular variables instead of atomics
 struct ConnectionState {
     std::chrono::steady_clock::time_point last_data_time;
     bool should_stop;
@@ -56,342 +58,390 @@ struct ConnectionState {
     }
 };
 
-std::unordered_map<std::string, std::unique_ptr<ConnectionState>> connection_states;
-std::mutex connection_states_mutex;
+// An instrument's working book, written only by its reactor thread, the
+// snapshots and BBO it publishes for everyone else to read, and the state
+// of its connection
+struct InstrumentFeed {
+    OrderBook book{BookMode::L2}; // sFOX publishes aggregated levels
+    SnapshotSlot snapshots;
+    TopOfBookCache top;
+    ConnectionState connection;
+    const InstrumentSpec* spec = nullptr; // set with depthLimit when the instrument is subscribed
+    size_t depthLimit = 0;
+};
 
-void connectToInstrument(const std::string& instrument) {
-    const std::string uri = "wss://ws.sfox.com/ws";
-    
-    // Initialize connection state
-    {
-        std::lock_guard<std::mutex> lock(connection_states_mutex);
-        connection_states[instrument] = std::make_unique<ConnectionState>();
+// sFOX addresses each feed message to its feed name in "recipient"
+const std::string ORDERBOOK_FEED_PREFIX = "orderbook.sfox.";
+
+// Feeds packed onto one websocket before another is opened
+constexpr size_t MAX_FEEDS_PER_CONNECTION = 50;
+
+// Instruments are interned when they are subscribed; afterwards the feed
+// sessions hold their entry by reference and readers look symbols up without locking
+InstrumentRegistry<InstrumentFeed> global_instruments;
+
+// One io_context and websocketpp endpoint; every instrument sharded onto it
+// is driven by the reactor's single thread, timers included
+struct FeedReactor {
+    asio::io_context io;
+    client endpoint;
+};
+
+// One websocket carrying the order book feeds of several instruments,
+// driven entirely by callbacks on its reactor's thread, which is therefore
+// the only writer of their books. Messages are routed to books by their
+// recipient. Nothing here may block: waits are asio timers on the reactor.
+//
+// Each connection authenticates, subscribes as soon as sFOX confirms the
+// authentication, then waits for its first book. A step that does not
+// complete within HANDSHAKE_TIMEOUT closes the connection, which reconnects.
+class FeedSession {
+public:
+    FeedSession(FeedReactor& reactor, std::vector<InstrumentId> ids, const std::string& apiKey)
+        : reactor(reactor),
+          instruments(std::move(ids)),
+          retryTimer(reactor.io),
+          handshakeTimer(reactor.io),
+          refreshTimer(reactor.io) {
+        json feeds = json::array();
+        for (InstrumentId id : instruments) {
+            if (!label.empty()) label += ",";
+            label += global_instruments.name(id);
+            feeds.push_back(ORDERBOOK_FEED_PREFIX + global_instruments.name(id));
+        }
+        authMessage = json{{"type", "authenticate"}, {"apiKey", apiKey}}.dump();
+        subscribeMessage = json{{"type", "subscribe"}, {"feeds", feeds}}.dump();
     }
 
-    while (true) {
-        try {
-            // Check if we should stop
-            {
-                std::lock_guard<std::mutex> lock(connection_states_mutex);
-                if (connection_states[instrument]->getShouldStop()) {
-                    break;
-                }
-            }
+    // Opens the first connection after delay, so a shard's sessions do not all dial at once
+    void start(std::chrono::milliseconds delay) {
+        retryTimer.expires_after(delay);
+        retryTimer.async_wait([this](const asio::error_code& ec) {
+            if (!ec) open();
+        });
+    }
 
-            client c;
-            c.init_asio();
-            
-            // Set access and error log levels to reduce noise
-            c.set_access_channels(websocketpp::log::alevel::none);
-            c.set_error_channels(websocketpp::log::elevel::none);
-
-            c.set_tls_init_handler([&instrument](websocketpp::connection_hdl) -> websocketpp::lib::shared_ptr<asio::ssl::context> {
-                try {
-                    auto ctx = websocketpp::lib::make_shared<asio::ssl::context>(asio::ssl::context::tlsv12_client);
-                    ctx->set_options(asio::ssl::context::default_workarounds |
-                                   asio::ssl::context::no_sslv2 |
-                                   asio::ssl::context::no_sslv3 |
-                                   asio::ssl::context::single_dh_use);
-                    return ctx;
-                } catch (const std::exception& e) {
-                    std::lock_guard<std::mutex> lock(output_mutex);
-                    std::cerr << "❌ [" << instrument << "] TLS initialization error: " << e.what() << "\n";
-                    throw;
-                }
-            });
-
-            // Simple connection tracking
-            bool is_connected = false;
-            bool is_authenticated = false;
-
-            c.set_open_handler([&c, &instrument, &is_connected, &is_authenticated](websocketpp::connection_hdl hdl) {
-                try {
-                    {
-                        std::lock_guard<std::mutex> lock(output_mutex);
-                        std::cout << "🔗 Connected to sFOX WebSocket for instrument: " << instrument << "\n";
-                    }
-                    
-                    is_connected = true;
-                    
-                    // Update last data time on connection
-                    {
-                        std::lock_guard<std::mutex> lock(connection_states_mutex);
-                        if (connection_states.find(instrument) != connection_states.end()) {
-                            connection_states[instrument]->updateDataTime();
-                        }
-                    }
-
-                    auto config = loadConfig("config.cfg");
-                    std::string token = config.count("API_KEY") ? config["API_KEY"] : "";
-
-                    json auth = {
-                        {"type", "authenticate"},
-                        {"apiKey", token}
-                    };
-                    
-                    websocketpp::lib::error_code ec;
-                    c.send(hdl, auth.dump(), websocketpp::frame::opcode::text, ec);
-                    if (ec) {
-                        std::lock_guard<std::mutex> lock(output_mutex);
-                        std::cerr << "❌ [" << instrument << "] Failed to send authentication: " << ec.message() << "\n";
-                        c.close(hdl, websocketpp::close::status::protocol_error, "Auth send failed");
-                        return;
-                    }
-
-                    std::this_thread::sleep_for(std::chrono::seconds(1)); // Wait for authentication
-
-                    json subscribe = {
-                        {"type", "subscribe"},
-                        {"feeds", {"orderbook.sfox." + instrument}}
-                    };
-                    
-                    c.send(hdl, subscribe.dump(), websocketpp::frame::opcode::text, ec);
-                    if (ec) {
-                        std::lock_guard<std::mutex> lock(output_mutex);
-                        std::cerr << "❌ [" << instrument << "] Failed to send subscription: " << ec.message() << "\n";
-                        c.close(hdl, websocketpp::close::status::protocol_error, "Subscribe send failed");
-                        return;
-                    }
-                    
-                    is_authenticated = true;
-                    
-                } catch (const std::exception& e) {
-                    std::lock_guard<std::mutex> lock(output_mutex);
-                    std::cerr << "❌ [" << instrument << "] Error in open handler: " << e.what() << "\n";
-                    is_connected = false;
-                }
-            });
-
-            const size_t DEPTH_LIMIT = 10;
-
-            c.set_message_handler([&instrument, &is_connected, &is_authenticated, DEPTH_LIMIT](websocketpp::connection_hdl hdl, message_ptr msg) {
-                try {
-                    // Update last data time
-                    {
-                        std::lock_guard<std::mutex> lock(connection_states_mutex);
-                        if (connection_states.find(instrument) != connection_states.end()) {
-                            connection_states[instrument]->updateDataTime();
-                        }
-                    }
-
-                    auto payload = json::parse(msg->get_payload());
-                    
-                    // Check for authentication response
-                    if (payload.contains("type") && payload["type"] == "authenticate") {
-                        if (payload.contains("success") && payload["success"] == true) {
-                            std::lock_guard<std::mutex> lock(output_mutex);
-                            std::cout << "✅ [" << instrument << "] Authentication successful\n";
-                        } else {
-                            std::lock_guard<std::mutex> lock(output_mutex);
-                            std::cerr << "❌ [" << instrument << "] Authentication failed\n";
-                            return;
-                        }
-                    }
-
-                    if (payload.contains("payload") &&
-                        (payload["payload"].contains("bids") || payload["payload"].contains("asks"))) {
-
-                        const auto& data = payload["payload"];
-                        json orderbook_data;
-
-                        if (data.contains("bids")) {
-                            std::vector<json> sorted_bids = data["bids"];
-                            std::sort(sorted_bids.begin(), sorted_bids.end(), [](const json& a, const json& b) {
-                                return a[0].get<double>() > b[0].get<double>();
-                            });
-
-                            json top_bids = json::array();
-                            for (size_t i = 0; i < std::min(sorted_bids.size(), DEPTH_LIMIT); ++i) {
-                                top_bids.push_back(sorted_bids[i]);
-                            }
-                            orderbook_data["bids"] = top_bids;
-                        }
-
-                        if (data.contains("asks")) {
-                            std::vector<json> sorted_asks = data["asks"];
-                            std::sort(sorted_asks.begin(), sorted_asks.end(), [](const json& a, const json& b) {
-                                return a[0].get<double>() < b[0].get<double>();
-                            });
-
-                            json top_asks = json::array();
-                            for (size_t i = 0; i < std::min(sorted_asks.size(), DEPTH_LIMIT); ++i) {
-                                top_asks.push_back(sorted_asks[i]);
-                            }
-                            orderbook_data["asks"] = top_asks;
-                        }
-
-                        {
-                            std::lock_guard<std::mutex> lock(orderbook_mutex);
-                            global_orderbooks[instrument].setOrderBook(orderbook_data);
-                        }
-
-                        {
-                            std::lock_guard<std::mutex> lock(output_mutex);
-                            std::cout << "📈 [" << instrument << "] Orderbook updated\n";
-                        }
-                    } else {
-                        std::lock_guard<std::mutex> lock(output_mutex);
-                        std::cout << "🔍 [" << instrument << "] Non-orderbook message:\n";
-                        std::cout << payload.dump(2) << "\n";
-                    }
-                } catch (const json::parse_error& e) {
-                    std::lock_guard<std::mutex> lock(output_mutex);
-                    std::cerr << "❌ [" << instrument << "] JSON parse error: " << e.what() << "\n";
-                    std::cerr << "Raw message: " << msg->get_payload() << "\n";
-                } catch (const json::type_error& e) {
-                    std::lock_guard<std::mutex> lock(output_mutex);
-                    std::cerr << "❌ [" << instrument << "] JSON type error: " << e.what() << "\n";
-                } catch (const std::exception& e) {
-                    std::lock_guard<std::mutex> lock(output_mutex);
-                    std::cerr << "❌ [" << instrument << "] Message handler error: " << e.what() << "\n";
-                }
-            });
-
-            c.set_fail_handler([&instrument, &is_connected](websocketpp::connection_hdl) {
-                std::lock_guard<std::mutex> lock(output_mutex);
-                std::cerr << "❌ [" << instrument << "] WebSocket connection failed. Will retry.\n";
-                is_connected = false;
-            });
-
-            c.set_close_handler([&instrument, &is_connected](websocketpp::connection_hdl) {
-                std::lock_guard<std::mutex> lock(output_mutex);
-                std::cerr << "🔌 [" << instrument << "] WebSocket closed. Will reconnect.\n";
-                is_connected = false;
-            });
-
-            websocketpp::lib::error_code ec;
-            client::connection_ptr con = c.get_connection(uri, ec);
-            if (ec) {
-                std::lock_guard<std::mutex> lock(output_mutex);
-                std::cerr << "❌ [" << instrument << "] Connection setup failed: " << ec.message() << "\n";
-                std::this_thread::sleep_for(std::chrono::seconds(2));
-                continue;
+private:
+    static constexpr const char* URI = "wss://ws.sfox.com/ws";
+    static constexpr std::chrono::minutes RECONNECT_INTERVAL{30};
+    static constexpr std::chrono::seconds HANDSHAKE_TIMEOUT{10};
+
+    enum class Handshake {
+        Connecting,     // TCP, TLS and websocket upgrade
+        Authenticating, // authenticate sent; the order book feeds do not need it to succeed
+        Subscribed,     // subscribe sent, no book yet
+        Streaming
+    };
+
+    void open() {
+        if (stopped()) return;
+        handshake = Handshake::Connecting;
+        dialed = std::chrono::steady_clock::now();
+
+        websocketpp::lib::error_code ec;
+        client::connection_ptr con = reactor.endpoint.get_connection(URI, ec);
+        if (ec) {
+            LOG_ERROR("❌ [{}] Connection setup failed: {}\n", label, ec.message());
+            retryAfter(std::chrono::seconds(2));
+            return;
+        }
+
+        con->set_open_handler([this](websocketpp::connection_hdl hdl) { onOpen(hdl); });
+        con->set_message_handler([this](websocketpp::connection_hdl, message_ptr msg) { onMessage(msg); });
+        con->set_fail_handler([this](websocketpp::connection_hdl) {
+            LOG_ERROR("❌ [{}] WebSocket connection failed. Will retry.\n", label);
+            onDisconnected();
+        });
+        con->set_close_handler([this](websocketpp::connection_hdl) {
+            LOG_WARN("🔌 [{}] WebSocket closed. Will reconnect.\n", label);
+            onDisconnected();
+        });
+
+        reactor.endpoint.connect(con);
+    }
+
+    void onOpen(websocketpp::connection_hdl hdl) {
+        connection = hdl;
+        opened = std::chrono::steady_clock::now();
+        LOG_INFO("🔗 Connected to sFOX WebSocket for instruments: {}\n", label);
+
+        // Update last data time on connection
+        for (InstrumentId id : instruments) global_instruments[id].connection.updateDataTime();
+
+        if (!send(authMessage, "authentication")) return;
+        advance(Handshake::Authenticating);
+
+        // Periodically reconnect to refresh the connection
+        refreshTimer.expires_after(RECONNECT_INTERVAL);
+        refreshTimer.async_wait([this](const asio::error_code& ec) {
+            if (ec) return;
+            LOG_INFO("🔄 [{}] 30 minutes elapsed. Forcing reconnection for connection refresh.\n", label);
+            close(websocketpp::close::status::going_away, "Scheduled reconnection");
+        });
+    }
+
+    // Enters a handshake step and gives it HANDSHAKE_TIMEOUT to complete
+    void advance(Handshake next) {
+        handshake = next;
+        handshakeTimer.expires_after(HANDSHAKE_TIMEOUT);
+        handshakeTimer.async_wait([this, next](const asio::error_code& ec) {
+            if (ec || handshake != next) return;
+            if (next == Handshake::Authenticating) {
+                LOG_WARN("⏰ [{}] No authentication reply after {} s, subscribing without it\n", label,
+                         HANDSHAKE_TIMEOUT.count());
+                subscribe();
+                return;
             }
+            LOG_ERROR("⏰ [{}] Waiting for the first book timed out after {} s, reconnecting\n", label,
+                      HANDSHAKE_TIMEOUT.count());
+            close(websocketpp::close::status::going_away, "Handshake timeout");
+        });
+    }
 
-            c.connect(con);
-
-            // Start reconnection timer thread (30 minutes)
-            bool timer_thread_running = true;
-            auto connection_start_time = std::chrono::steady_clock::now();
-            const std::chrono::minutes RECONNECT_INTERVAL(30);
-            
-            std::thread timer_thread([&instrument, &c, con, &is_connected, &timer_thread_running, RECONNECT_INTERVAL, connection_start_time]() {
-                while (timer_thread_running && is_connected) {
-                    std::this_thread::sleep_for(std::chrono::seconds(1));
-                    
-                    if (!timer_thread_running || !is_connected) break;
-                    
-                    auto now = std::chrono::steady_clock::now();
-                    auto elapsed = now - connection_start_time;
-                    
-                    if (elapsed >= RECONNECT_INTERVAL) {
-                        std::lock_guard<std::mutex> lock(output_mutex);
-                        std::cout << "🔄 [" << instrument << "] 30 minutes elapsed. Forcing reconnection for connection refresh.\n";
-                        
-                        try {
-                            c.close(con, websocketpp::close::status::going_away, "Scheduled reconnection");
-                        } catch (const std::exception& e) {
-                            std::lock_guard<std::mutex> lock2(output_mutex);
-                            std::cerr << "❌ [" << instrument << "] Error closing connection on scheduled reconnection: " 
-                                      << e.what() << "\n";
-                        }
-                        is_connected = false;
-                        break;
-                    }
-                }
-            });
+    // Subscribes whatever the authentication outcome, as the order book feeds
+    // are public; a missing or rejected API_KEY only costs the private channels
+    void subscribe() {
+        authenticated = std::chrono::steady_clock::now();
+        if (!send(subscribeMessage, "subscription")) return;
+        advance(Handshake::Subscribed);
+    }
 
-            try {
-                c.run(); // blocks until connection closes
-            } catch (const websocketpp::exception& e) {
-                std::lock_guard<std::mutex> lock(output_mutex);
-                std::cerr << "❌ [" << instrument << "] WebSocket++ exception: " << e.what() << "\n";
-            } catch (const std::exception& e) {
-                std::lock_guard<std::mutex> lock(output_mutex);
-                std::cerr << "❌ [" << instrument << "] Exception in run(): " << e.what() << "\n";
+    // Called for the connection's first book, once per connect
+    void onFirstBook() {
+        handshake = Handshake::Streaming;
+        handshakeTimer.cancel();
+        retryCount = 0;
+
+        auto now = std::chrono::steady_clock::now();
+        auto ms = [](std::chrono::steady_clock::duration elapsed) {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+        };
+        LOG_INFO("⏱️ [{}] First book {} ms after connect (open {} ms, auth {} ms, subscribe to book {} ms)\n", label,
+                 ms(now - dialed), ms(opened - dialed), ms(authenticated - opened), ms(now - authenticated));
+    }
+
+    void close(websocketpp::close::status::value code, const std::string& reason) {
+        websocketpp::lib::error_code ec;
+        reactor.endpoint.close(connection, code, reason, ec);
+        if (ec) LOG_ERROR("❌ [{}] Error closing connection: {}\n", label, ec.message());
+    }
+
+    // Closes the connection if the send fails; the close handler then reconnects
+    bool send(const std::string& message, const char* what) {
+        websocketpp::lib::error_code ec;
+        reactor.endpoint.send(connection, message, websocketpp::frame::opcode::text, ec);
+        if (!ec) return true;
+        LOG_ERROR("❌ [{}] Failed to send {}: {}\n", label, what, ec.message());
+        reactor.endpoint.close(connection, websocketpp::close::status::protocol_error, "Send failed", ec);
+        return false;
+    }
+
+    void onMessage(const message_ptr& msg) {
+        const auto received = std::chrono::system_clock::now();
+
+        // Book updates are read in one pass straight into the level buffers;
+        // anything else is rare and goes through the json DOM below
+        if (SfoxParser::parse(msg->get_payload(), parsed) && parsed.hasBook()) {
+            InstrumentId id = route(parsed.recipient);
+            if (id != NO_INSTRUMENT) {
+                applyBook(id, received);
+                if (handshake != Handshake::Streaming) onFirstBook();
+                return;
             }
+        }
 
-            is_connected = false;
-            timer_thread_running = false;
-            
-            // Wait for timer thread to finish
-            if (timer_thread.joinable()) {
-                timer_thread.join();
+        try {
+            auto payload = json::parse(msg->get_payload());
+
+            // Check for authentication response
+            if (payload.contains("type") && payload["type"] == "authenticate") {
+                if (handshake != Handshake::Authenticating) return;
+                if (payload.contains("success") && payload["success"] == true) {
+                    LOG_INFO("✅ [{}] Authentication successful\n", label);
+                } else {
+                    LOG_WARN("⚠️ [{}] Authentication failed, subscribing to the public order books without it\n", label);
+                }
+                subscribe();
+                return;
             }
 
-        } catch (const std::bad_alloc& e) {
-            std::lock_guard<std::mutex> lock(output_mutex);
-            std::cerr << "💾 [" << instrument << "] Memory allocation error: " << e.what() << "\n";
-        } catch (const std::system_error& e) {
-            std::lock_guard<std::mutex> lock(output_mutex);
-            std::cerr << "🔧 [" << instrument << "] System error: " << e.what() << " (code: " << e.code() << ")\n";
+            LOG_INFO("🔍 [{}] Non-orderbook message:\n{}\n", label, msg->get_payload());
+        } catch (const json::parse_error& e) {
+            LOG_ERROR("❌ [{}] JSON parse error: {}\nRaw message: {}\n", label, e.what(), msg->get_payload());
         } catch (const std::exception& e) {
-            std::lock_guard<std::mutex> lock(output_mutex);
-            std::cerr << "🚨 [" << instrument << "] Exception in WebSocket loop: " << e.what() << "\n";
-        } catch (...) {
-            std::lock_guard<std::mutex> lock(output_mutex);
-            std::cerr << "⚠️ [" << instrument << "] Unknown exception in WebSocket loop\n";
+            LOG_ERROR("❌ [{}] Message handler error: {}\n", label, e.what());
         }
+    }
 
-        // Check if we should stop before reconnecting
-        {
-            std::lock_guard<std::mutex> lock(connection_states_mutex);
-            if (connection_states.find(instrument) != connection_states.end() && 
-                connection_states[instrument]->getShouldStop()) {
-                break;
-            }
-        }
+    // Replaces the instrument's book with the levels just parsed and publishes it
+    void applyBook(InstrumentId id, std::chrono::system_clock::time_point received) {
+        InstrumentFeed& feed = global_instruments[id];
+
+        // Update last data time
+        feed.connection.updateDataTime();
+
+        selectTopLevels(parsed.bids, Side::Bid, *feed.spec, feed.depthLimit, topBids);
+        selectTopLevels(parsed.asks, Side::Ask, *feed.spec, feed.depthLimit, topAsks);
+
+        // Readers only ever see published snapshots, so no lock is needed here
+        feed.book.setOrderBook(topBids, topAsks);
+        feed.snapshots.publish(feed.book);
+
+        // sFOX stamps each message in ns since epoch
+        feed.top.publish(feed.book, parsed.timestamp,
+                         std::chrono::duration_cast<std::chrono::nanoseconds>(received.time_since_epoch()).count());
+
+        LOG_INFO("📈 [{}] Orderbook updated\n", global_instruments.name(id));
+    }
+
+    void onDisconnected() {
+        handshake = Handshake::Connecting;
+        handshakeTimer.cancel();
+        refreshTimer.cancel();
+        if (stopped()) return;
 
         // Exponential backoff for reconnection
-        static thread_local int retry_count = 0;
-        int delay = std::min(2 * (1 << retry_count), 30); // Max 30 seconds
-        retry_count = (retry_count + 1) % 5; // Reset after 5 attempts to avoid overflow
-        
-        std::this_thread::sleep_for(std::chrono::seconds(delay));
-        std::lock_guard<std::mutex> lock(output_mutex);
-        std::cout << "🔁 [" << instrument << "] Attempting reconnect in " << delay << " seconds...\n";
+        int delay = std::min(2 * (1 << retryCount), 30); // Max 30 seconds
+        retryCount = (retryCount + 1) % 5; // Reset after 5 attempts to avoid overflow
+        LOG_INFO("🔁 [{}] Attempting reconnect in {} seconds...\n", label, delay);
+        retryAfter(std::chrono::seconds(delay));
     }
-    
-    // Clean up connection state
-    {
-        std::lock_guard<std::mutex> lock(connection_states_mutex);
-        connection_states.erase(instrument);
+
+    // The subscribed instrument a feed message is addressed to, NO_INSTRUMENT otherwise
+    InstrumentId route(std::string_view recipient) const {
+        if (recipient.substr(0, ORDERBOOK_FEED_PREFIX.size()) != ORDERBOOK_FEED_PREFIX) return NO_INSTRUMENT;
+
+        InstrumentId id = global_instruments.find(recipient.substr(ORDERBOOK_FEED_PREFIX.size()));
+        return std::find(instruments.begin(), instruments.end(), id) != instruments.end() ? id : NO_INSTRUMENT;
+    }
+
+    // Stops reconnecting once every instrument on the connection is stopped
+    bool stopped() const {
+        return std::all_of(instruments.begin(), instruments.end(),
+                           [](InstrumentId id) { return global_instruments[id].connection.getShouldStop(); });
+    }
+
+    void retryAfter(std::chrono::seconds delay) {
+        retryTimer.expires_after(delay);
+        retryTimer.async_wait([this](const asio::error_code& ec) {
+            if (!ec) open();
+        });
+    }
+
+    FeedReactor& reactor;
+    const std::vector<InstrumentId> instruments;
+    std::string label; // the instruments' symbols, for logging
+    std::string authMessage; // built once; reconnects resend them as they are
+    std::string subscribeMessage;
+    asio::steady_timer retryTimer;
+    asio::steady_timer handshakeTimer;
+    asio::steady_timer refreshTimer;
+    websocketpp::connection_hdl connection;
+    Handshake handshake = Handshake::Connecting;
+    std::chrono::steady_clock::time_point dialed; // the current connection's handshake milestones
+    std::chrono::steady_clock::time_point opened;
+    std::chrono::steady_clock::time_point authenticated;
+    int retryCount = 0;
+
+    // Parse and level buffers shared by the connection's instruments and
+    // reused across messages, so the snapshot path does not allocate once warm
+    SfoxMessage parsed;
+    std::vector<Order> topBids;
+    std::vector<Order> topAsks;
+};
+
+// Runs one reactor until every session on it is stopped
+void runReactor(FeedReactor& reactor, size_t index) {
+    while (true) {
+        try {
+            reactor.io.run();
+            return;
+        } catch (const websocketpp::exception& e) {
+            LOG_ERROR("❌ [reactor {}] WebSocket++ exception: {}\n", index, e.what());
+        } catch (const std::exception& e) {
+            LOG_ERROR("🚨 [reactor {}] Exception in run(): {}\n", index, e.what());
+        } catch (...) {
+            LOG_WARN("⚠️ [reactor {}] Unknown exception in run()\n", index);
+        }
     }
 }
 
-void WebSocketClient::connect(const std::vector<std::string>& instruments) {
+void WebSocketClient::connect(const std::vector<std::string>& instruments, size_t reactors) {
     if (instruments.empty()) {
-        std::cerr << "❌ No instruments provided\n";
+        LOG_ERROR("❌ No instruments provided\n");
         return;
     }
 
-    // Limit to maximum 10 connections
-    size_t max_connections = std::min(instruments.size(), static_cast<size_t>(10));
-    
-    std::cout << "🚀 Starting " << max_connections << " WebSocket connections...\n";
-    
-    // Initialize orderbooks and connection states for each instrument
-    {
-        std::lock_guard<std::mutex> lock(orderbook_mutex);
-        std::lock_guard<std::mutex> state_lock(connection_states_mutex);
-        for (size_t i = 0; i < max_connections; ++i) {
-            global_orderbooks[instruments[i]] = OrderBook();
-            connection_states[instruments[i]] = std::make_unique<ConnectionState>();
+    // Intern each instrument once; its book and connection state live in the registry from here on
+    std::vector<InstrumentId> ids;
+    ids.reserve(instruments.size());
+    for (const auto& instrument : instruments) {
+        InstrumentId id = global_instruments.intern(instrument);
+        if (id == NO_INSTRUMENT) {
+            LOG_ERROR("❌ [{}] Instrument registry is full, skipping\n", instrument);
+        } else if (std::find(ids.begin(), ids.end(), id) == ids.end()) {
+            InstrumentFeed& feed = global_instruments[id];
+            feed.spec = &getInstrumentSpec(instrument);
+            feed.depthLimit = bookDepth(instrument); // build-time per-instrument depth
+            ids.push_back(id);
         }
     }
-    
+    if (ids.empty()) return;
+
+    const size_t connections = (ids.size() + MAX_FEEDS_PER_CONNECTION - 1) / MAX_FEEDS_PER_CONNECTION;
+    reactors = std::max<size_t>(1, std::min(reactors, connections));
+    LOG_INFO("🚀 Starting {} WebSocket connection(s) for {} instruments on {} reactor thread(s)...\n",
+             connections, ids.size(), reactors);
+
+    // Credentials are read once; every connect and reconnect reuses them
+    auto config = loadConfig("config.cfg");
+    const std::string apiKey = config.count("API_KEY") ? config["API_KEY"] : "";
+
+    std::vector<std::unique_ptr<FeedReactor>> shards;
+    for (size_t i = 0; i < reactors; ++i) {
+        auto reactor = std::make_unique<FeedReactor>();
+        reactor->endpoint.init_asio(&reactor->io);
+
+        // Set access and error log levels to reduce noise
+        reactor->endpoint.set_access_channels(websocketpp::log::alevel::none);
+        reactor->endpoint.set_error_channels(websocketpp::log::elevel::none);
+
+        reactor->endpoint.set_tls_init_handler([](websocketpp::connection_hdl) -> websocketpp::lib::shared_ptr<asio::ssl::context> {
+            try {
+                auto ctx = websocketpp::lib::make_shared<asio::ssl::context>(asio::ssl::context::tlsv12_client);
+                ctx->set_options(asio::ssl::context::default_workarounds |
+                               asio::ssl::context::no_sslv2 |
+                               asio::ssl::context::no_sslv3 |
+                               asio::ssl::context::single_dh_use);
+                return ctx;
+            } catch (const std::exception& e) {
+                LOG_ERROR("❌ TLS initialization error: {}\n", e.what());
+                throw;
+            }
+        });
+        shards.push_back(std::move(reactor));
+    }
+
+    // Instruments are packed onto connections, connections are dealt
+    // round-robin across the reactors, and each reactor staggers its
+    // connection attempts to avoid overwhelming the server
+    std::vector<std::unique_ptr<FeedSession>> sessions;
+    sessions.reserve(connections);
+    for (size_t i = 0; i < connections; ++i) {
+        auto first = ids.begin() + i * MAX_FEEDS_PER_CONNECTION;
+        auto last = ids.begin() + std::min(ids.size(), (i + 1) * MAX_FEEDS_PER_CONNECTION);
+        sessions.push_back(std::make_unique<FeedSession>(*shards[i % reactors], std::vector<InstrumentId>(first, last), apiKey));
+        sessions.back()->start(std::chrono::milliseconds(100 * (i / reactors)));
+    }
+
     std::vector<std::thread> threads;
-    threads.reserve(max_connections);
-
-    // Create a thread for each instrument (up to 10)
-    for (size_t i = 0; i < max_connections; ++i) {
-        threads.emplace_back(connectToInstrument, instruments[i]);
-        
-        // Small delay between connection attempts to avoid overwhelming the server
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    threads.reserve(reactors - 1);
+    for (size_t i = 1; i < reactors; ++i) {
+        threads.emplace_back(runReactor, std::ref(*shards[i]), i);
     }
+    runReactor(*shards[0], 0);
 
-    // Wait for all threads to complete
+    // Wait for all reactors to complete
     for (auto& thread : threads) {
         if (thread.joinable()) {
             thread.join();
@@ -399,32 +449,52 @@ void WebSocketClient::connect(const std::vector<std::string>& instruments) {
     }
 }
 
-// Function to get orderbook for a specific instrument (thread-safe)
-OrderBook WebSocketClient::getOrderBook(const std::string& instrument) {
-    extern std::unordered_map<std::string, OrderBook> global_orderbooks;
-    extern std::mutex orderbook_mutex;
-    
-    std::lock_guard<std::mutex> lock(orderbook_mutex);
-    auto it = global_orderbooks.find(instrument);
-    if (it != global_orderbooks.end()) {
-        return it->second;
-    }
-    return OrderBook(); // Return empty orderbook if not found
+InstrumentId WebSocketClient::findInstrument(const std::string& symbol) {
+    return global_instruments.find(symbol);
+}
+
+// Function to get the latest snapshot for an instrument (lock-free, never waits on the feed)
+std::shared_ptr<const BookSnapshot> WebSocketClient::getSnapshot(InstrumentId id) {
+    static const auto EMPTY = std::make_shared<const BookSnapshot>();
+    return id < global_instruments.size() ? global_instruments[id].snapshots.load() : EMPTY; // Empty snapshot if not found
+}
+
+std::shared_ptr<const BookSnapshot> WebSocketClient::getSnapshot(const std::string& instrument) {
+    return getSnapshot(findInstrument(instrument));
+}
+
+// Latest best bid/offer for an instrument, read through its seqlock without blocking the feed
+TopOfBook WebSocketClient::getTopOfBook(InstrumentId id) {
+    return id < global_instruments.size() ? global_instruments[id].top.load() : TopOfBook{}; // Empty record if not found
+}
+
+TopOfBook WebSocketClient::getTopOfBook(const std::string& instrument) {
+    return getTopOfBook(findInstrument(instrument));
 }
 
 // Function to get all available instruments
 std::vector<std::string> WebSocketClient::getAvailableInstruments() {
-    extern std::unordered_map<std::string, OrderBook> global_orderbooks;
-    extern std::mutex orderbook_mutex;
-    
-    std::lock_guard<std::mutex> lock(orderbook_mutex);
     std::vector<std::string> instruments;
-    for (const auto& pair : global_orderbooks) {
-        instruments.push_back(pair.first);
+    for (InstrumentId id = 0; id < global_instruments.size(); ++id) {
+        instruments.push_back(global_instruments.name(id));
     }
     return instruments;
 }
 
+void WebSocketClient::dumpStats(std::ostream& out) {
+    for (InstrumentId id = 0; id < global_instruments.size(); ++id) {
+        std::shared_ptr<const BookSnapshot> snapshot = global_instruments[id].snapshots.load();
+        const BookStats& stats = snapshot->stats();
+        double operations = static_cast<double>(std::max<std::uint64_t>(stats.operations(), 1));
+        out << "🧮 " << global_instruments.name(id) << " levels " << stats.bidLevels << "/" << stats.askLevels
+            << " (max " << stats.maxBidLevels << "/" << stats.maxAskLevels << ")"
+            << " | updates " << stats.levelUpdates << " snapshots " << stats.snapshots
+            << " | " << stats.memory.bytesInUse << "B in use, " << std::setprecision(2)
+            << stats.memory.allocations / operations << " allocs/op"
+            << " | heap " << stats.memory.heapBytes << "B in " << stats.memory.heapAllocations << " blocks\n";
+    }
+}
+
 std::unordered_map<std::string, std::string> loadConfig(const std::string& path) {
     std::unordered_map<std::string, std::string> config;
     std::ifstream file(path);
@@ -445,5 +515,5 @@ std::unordered_map<std::string, std::string> loadConfig(const std::string& path)
 }
 
 bool WebSocketClient::hasOrderBook(const std::string& symbol) {
-    return global_orderbooks.find(symbol) != global_orderbooks.end();
+    return global_instruments.contains(symbol);
 }
\ No newline at end of file
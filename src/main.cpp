@@ -1,6 +1,9 @@
 #include "WebSocketClient.h"
-#include "trading/OrderBook.h"
+#include "trading/BookSnapshot.h"
+#include "trading/Instrument.h"
 #include "OrderBookServer.h"
+#include <algorithm>
+#include <array>
 #include <iostream>
 #include <vector>
 #include <thread>
@@ -8,42 +11,40 @@
 #include <iomanip>
 #include <grpcpp/grpcpp.h>
 
-void printOrderBookState(const std::string& instrument, const OrderBook& orderbook) {
+void printOrderBookState(const std::string& instrument, const BookSnapshot& orderbook) {
     std::cout << "\n=== " << instrument << " OrderBook State ===\n";
+    const InstrumentSpec& spec = getInstrumentSpec(instrument);
     
     try {
-        // Get bids and asks
-        auto bids = orderbook.getBids();
-        auto asks = orderbook.getAsks();
+        // Only the top 5 levels are shown, so copy just those
+        const size_t DISPLAY_DEPTH = 5;
+        std::array<BookLevel, DISPLAY_DEPTH> bids;
+        std::array<BookLevel, DISPLAY_DEPTH> asks;
+        size_t bidCount = orderbook.topBids(DISPLAY_DEPTH, bids.data());
+        size_t askCount = orderbook.topAsks(DISPLAY_DEPTH, asks.data());
         
         // Print best bid/ask if available
-        if (!bids.empty() && !asks.empty()) {
-            std::cout << "📊 Best Bid: $" << std::fixed << std::setprecision(2) << orderbook.bestBid()
-                      << " | Best Ask: $" << orderbook.bestAsk() 
-                      << " | Spread: $" << (orderbook.bestAsk() - orderbook.bestBid()) << "\n";
+        if (bidCount > 0 && askCount > 0) {
+            std::cout << "📊 Best Bid: $" << std::fixed << std::setprecision(2) << spec.fromTicks(orderbook.bestBid())
+                      << " | Best Ask: $" << spec.fromTicks(orderbook.bestAsk()) 
+                      << " | Spread: $" << spec.fromTicks(orderbook.bestAsk() - orderbook.bestBid()) << "\n";
         }
         
         // Print top 5 bids
         std::cout << "\n🟢 Top Bids:\n";
-        int count = 0;
-        for (const auto& bid : bids) {
-            if (count >= 5) break;
+        for (size_t i = 0; i < bidCount; ++i) {
             std::cout << "  " << std::fixed << std::setprecision(2) 
-                      << "$" << bid.price << " x " << bid.volume << "\n";
-            count++;
+                      << "$" << spec.fromTicks(bids[i].price) << " x " << spec.fromLots(bids[i].volume) << "\n";
         }
         
         // Print top 5 asks
         std::cout << "\n🔴 Top Asks:\n";
-        count = 0;
-        for (const auto& ask : asks) {
-            if (count >= 5) break;
+        for (size_t i = 0; i < askCount; ++i) {
             std::cout << "  " << std::fixed << std::setprecision(2) 
-                      << "$" << ask.price << " x " << ask.volume << "\n";
-            count++;
+                      << "$" << spec.fromTicks(asks[i].price) << " x " << spec.fromLots(asks[i].volume) << "\n";
         }
         
-        if (bids.empty() && asks.empty()) {
+        if (bidCount == 0 && askCount == 0) {
             std::cout << "⚠️  No orderbook data available yet...\n";
         }
         
@@ -77,9 +78,12 @@ void monitorOrderBooks(const std::vector<std::string>& instruments) {
         
         // Print state for each instrument
         for (const auto& instrument : instruments) {
-            OrderBook orderbook = WebSocketClient::getOrderBook(instrument);
-            printOrderBookState(instrument, orderbook);
+            std::shared_ptr<const BookSnapshot> orderbook = WebSocketClient::getSnapshot(instrument);
+            printOrderBookState(instrument, *orderbook);
         }
+
+        std::cout << "\n";
+        WebSocketClient::dumpStats(std::cout);
         
         std::cout << std::string(60, '=') << "\n";
         
@@ -88,7 +92,10 @@ void monitorOrderBooks(const std::vector<std::string>& instruments) {
     }
 }
 
-int main() {
+int main(int argc, char** argv) {
+    // --monitor prints every book and its stats every 5 seconds
+    bool monitor = std::find(argv + 1, argv + argc, std::string("--monitor")) != argv + argc;
+
     // Create WebSocket client
     WebSocketClient client;
     
@@ -114,12 +121,13 @@ int main() {
     std::thread grpc_thread(RunServer);
     
     // Start monitoring orderbooks in a separate thread
-    //std::thread monitor_thread(monitorOrderBooks, instruments);
+    std::thread monitor_thread;
+    if (monitor) monitor_thread = std::thread(monitorOrderBooks, instruments);
     
     std::cout << "🎯 All services started successfully!\n";
     std::cout << "   - WebSocket connections: Running\n";
     std::cout << "   - gRPC server: Running on 0.0.0.0:50051\n";
-    std::cout << "   - OrderBook monitor: Running\n\n";
+    std::cout << "   - OrderBook monitor: " << (monitor ? "Running" : "Off (start with --monitor)") << "\n\n";
     
     // Keep main thread alive
     while (true) {
@@ -129,7 +137,7 @@ int main() {
     // Clean up threads (this will never be reached due to infinite loop above)
     if (connection_thread.joinable()) connection_thread.join();
     if (grpc_thread.joinable()) grpc_thread.join();
-    //if (monitor_thread.joinable()) monitor_thread.join();
+    if (monitor_thread.joinable()) monitor_thread.join();
     
     return 0;
 }
\ No newline at end of file
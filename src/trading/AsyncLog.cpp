@@ -0,0 +1,150 @@
+#include "trading/AsyncLog.h"
+
+#include <charconv>
+#include <chrono>
+#include <iostream>
+
+namespace {
+
+// How long the drain thread sleeps when it found nothing to write
+constexpr std::chrono::milliseconds IDLE_WAIT{1};
+
+std::atomic<std::uint64_t> nextLogId{1};
+
+template <typename Raw>
+const char* take(const char* in, Raw& raw) {
+    std::memcpy(&raw, in, sizeof raw);
+    return in + sizeof raw;
+}
+
+template <typename Number>
+void appendNumber(std::string& line, Number value) {
+    char text[32];
+    auto result = std::to_chars(text, text + sizeof text, value);
+    line.append(text, result.ptr);
+}
+
+// Appends one encoded argument and returns where the next one starts
+const char* appendArg(std::string& line, const char* in) {
+    auto type = static_cast<logdetail::ArgType>(*in++);
+    switch (type) {
+    case logdetail::ArgType::Signed: {
+        std::int64_t value;
+        in = take(in, value);
+        appendNumber(line, value);
+        break;
+    }
+    case logdetail::ArgType::Unsigned: {
+        std::uint64_t value;
+        in = take(in, value);
+        appendNumber(line, value);
+        break;
+    }
+    case logdetail::ArgType::Double: {
+        double value;
+        in = take(in, value);
+        appendNumber(line, value);
+        break;
+    }
+    case logdetail::ArgType::Bool: {
+        std::uint64_t value;
+        in = take(in, value);
+        line += value ? "true" : "false";
+        break;
+    }
+    case logdetail::ArgType::String: {
+        std::uint32_t length;
+        in = take(in, length);
+        line.append(in, length);
+        in += length;
+        break;
+    }
+    }
+    return in;
+}
+
+void formatRecord(std::string& line, const LogRecordHeader& header, const char* args) {
+    line.clear();
+    std::uint32_t remaining = header.argCount;
+    for (const char* at = header.site->format; *at; ++at) {
+        if (at[0] == '{' && at[1] == '}' && remaining > 0) {
+            args = appendArg(line, args);
+            --remaining;
+            ++at;
+        } else {
+            line += *at;
+        }
+    }
+}
+
+} // namespace
+
+AsyncLog::AsyncLog(std::ostream& out, std::ostream& err)
+    : id(nextLogId.fetch_add(1)), out(out), err(err), drainer([this] { run(); }) {}
+
+AsyncLog::~AsyncLog() {
+    stopping.store(true, std::memory_order_release);
+    drainer.join();
+}
+
+AsyncLog& AsyncLog::instance() {
+    static AsyncLog log(std::cout, std::cerr);
+    return log;
+}
+
+std::uint64_t AsyncLog::dropped() const {
+    std::lock_guard<std::mutex> lock(registration);
+    std::uint64_t total = 0;
+    for (const auto& entry : rings) total += entry.second->droppedCount();
+    return total;
+}
+
+LogRing& AsyncLog::registerThread() {
+    std::lock_guard<std::mutex> lock(registration);
+    for (auto& entry : rings) {
+        if (entry.first == std::this_thread::get_id()) return *entry.second;
+    }
+    rings.emplace_back(std::this_thread::get_id(), std::make_unique<LogRing>());
+    ringCount.store(rings.size(), std::memory_order_release);
+    return *rings.back().second;
+}
+
+// The ring list is only copied when a thread has registered since the last pass
+void AsyncLog::run() {
+    std::vector<LogRing*> snapshot;
+    std::string line;
+    while (true) {
+        bool finishing = stopping.load(std::memory_order_acquire);
+        if (snapshot.size() != ringCount.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(registration);
+            snapshot.clear();
+            for (auto& entry : rings) snapshot.push_back(entry.second.get());
+        }
+        if (drainOnce(snapshot, line) == 0) {
+            if (finishing) return;
+            std::this_thread::sleep_for(IDLE_WAIT);
+        }
+    }
+}
+
+size_t AsyncLog::drainOnce(std::vector<LogRing*>& snapshot, std::string& line) {
+    size_t written = 0;
+    std::uint64_t droppedNow = 0;
+    for (LogRing* ring : snapshot) {
+        written += ring->consume([&](const LogRecordHeader& header, const char* args) {
+            formatRecord(line, header, args);
+            (header.site->level >= LogLevel::Warn ? err : out) << line;
+        });
+        droppedNow += ring->droppedCount();
+    }
+    if (droppedNow != droppedReported) {
+        err << "⚠️ Log rings full, " << droppedNow - droppedReported << " records dropped\n";
+        droppedReported = droppedNow;
+        ++written;
+    }
+    if (written > 0) {
+        out.flush();
+        err.flush();
+    }
+    return written;
+}
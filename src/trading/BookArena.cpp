@@ -0,0 +1,46 @@
+#include "trading/BookArena.h"
+
+CountingResource::CountingResource(std::pmr::memory_resource* upstream) : upstream(upstream) {}
+
+void* CountingResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+    void* p = upstream->allocate(bytes, alignment);
+    ++allocations;
+    bytesInUse += bytes;
+    return p;
+}
+
+void CountingResource::do_deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+    upstream->deallocate(p, bytes, alignment);
+    ++deallocations;
+    bytesInUse -= bytes;
+}
+
+bool CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+namespace {
+
+// Levels and order vectors are small; anything bigger (the ladder slot
+// arrays) is allocated once per book and goes straight to the heap
+std::pmr::pool_options arenaOptions() {
+    std::pmr::pool_options options;
+    options.max_blocks_per_chunk = 256;
+    options.largest_required_pool_block = 1024;
+    return options;
+}
+
+} // namespace
+
+BookArena::BookArena() : pool(arenaOptions(), &heap) {}
+
+AllocationStats BookArena::stats() const {
+    AllocationStats stats;
+    stats.allocations = front.allocations;
+    stats.deallocations = front.deallocations;
+    stats.bytesInUse = front.bytesInUse;
+    stats.heapAllocations = heap.allocations;
+    stats.heapDeallocations = heap.deallocations;
+    stats.heapBytes = heap.bytesInUse;
+    return stats;
+}
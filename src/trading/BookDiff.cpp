@@ -0,0 +1,117 @@
+#include "trading/BookDiff.h"
+
+namespace {
+
+// Cursors walking one side's non-empty levels best first
+
+class LevelCursor {
+public:
+    explicit LevelCursor(const std::vector<BookLevel>& levels) : it(levels.begin()), last(levels.end()) { skipEmpty(); }
+
+    bool done() const { return it == last; }
+    Price price() const { return it->price; }
+    Quantity volume() const { return it->volume; }
+    std::uint32_t orderCount() const { return it->orderCount; }
+
+    void next() {
+        ++it;
+        skipEmpty();
+    }
+
+private:
+    void skipEmpty() {
+        while (it != last && it->volume == 0) ++it;
+    }
+
+    std::vector<BookLevel>::const_iterator it;
+    std::vector<BookLevel>::const_iterator last;
+};
+
+// Folds runs of entries at the same price into one level, as setOrderBook does
+class OrderCursor {
+public:
+    explicit OrderCursor(const std::vector<Order>& orders) : it(orders.begin()), last(orders.end()) { next(); }
+
+    bool done() const { return exhausted; }
+    Price price() const { return level.price; }
+    Quantity volume() const { return level.volume; }
+    std::uint32_t orderCount() const { return level.orderCount; }
+
+    void next() {
+        do {
+            exhausted = it == last;
+            if (exhausted) return;
+            level = {it->price, 0, 0};
+            for (; it != last && it->price == level.price; ++it) {
+                level.volume += it->volume;
+                ++level.orderCount;
+            }
+        } while (level.volume == 0);
+    }
+
+private:
+    std::vector<Order>::const_iterator it;
+    std::vector<Order>::const_iterator last;
+    BookLevel level{0, 0, 0};
+    bool exhausted = false;
+};
+
+template <Side side, typename Before, typename After>
+void diffSide(Before before, After after, std::vector<LevelDelta>& out) {
+    auto better = [](Price a, Price b) { return side == Side::Bid ? a > b : a < b; };
+
+    while (!before.done() || !after.done()) {
+        if (after.done() || (!before.done() && better(before.price(), after.price()))) {
+            out.push_back({DeltaAction::Delete, side, before.price(), 0, 0});
+            before.next();
+        } else if (before.done() || better(after.price(), before.price())) {
+            out.push_back({DeltaAction::Add, side, after.price(), after.volume(), after.orderCount()});
+            after.next();
+        } else {
+            if (before.volume() != after.volume() || before.orderCount() != after.orderCount()) {
+                out.push_back({DeltaAction::Modify, side, after.price(), after.volume(), after.orderCount()});
+            }
+            before.next();
+            after.next();
+        }
+    }
+}
+
+} // namespace
+
+size_t BookDiff::diff(const OrderBook& before, const OrderBook& after) {
+    changes.clear();
+    diffSide<Side::Bid>(LevelCursor(copyLevels(before, Side::Bid, beforeLevels)),
+             LevelCursor(copyLevels(after, Side::Bid, afterLevels)), changes);
+    diffSide<Side::Ask>(LevelCursor(copyLevels(before, Side::Ask, beforeLevels)),
+             LevelCursor(copyLevels(after, Side::Ask, afterLevels)), changes);
+    return changes.size();
+}
+
+size_t BookDiff::diff(const BookSnapshot& before, const BookSnapshot& after) {
+    changes.clear();
+    diffSide<Side::Bid>(LevelCursor(before.getBids()), LevelCursor(after.getBids()), changes);
+    diffSide<Side::Ask>(LevelCursor(before.getAsks()), LevelCursor(after.getAsks()), changes);
+    return changes.size();
+}
+
+size_t BookDiff::diff(const OrderBook& before, const std::vector<Order>& bids, const std::vector<Order>& asks) {
+    changes.clear();
+    diffSide<Side::Bid>(LevelCursor(copyLevels(before, Side::Bid, beforeLevels)), OrderCursor(bids), changes);
+    diffSide<Side::Ask>(LevelCursor(copyLevels(before, Side::Ask, beforeLevels)), OrderCursor(asks), changes);
+    return changes.size();
+}
+
+// Flat copy of one side: walking the ladder's bitmap once is cheaper than
+// stepping its iterator through the merge
+const std::vector<BookLevel>& BookDiff::copyLevels(const OrderBook& book, Side side, std::vector<BookLevel>& levels) {
+    levels.resize(book.levelCount(side));
+    levels.resize(side == Side::Bid ? book.topBids(levels.size(), levels.data()) : book.topAsks(levels.size(), levels.data()));
+    return levels;
+}
+
+void BookDiff::applyTo(OrderBook& book) const {
+    for (const LevelDelta& delta : changes) {
+        book.applyUpdate(delta.side, delta.price, delta.volume);
+    }
+}
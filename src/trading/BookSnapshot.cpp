@@ -0,0 +1,84 @@
+#include "trading/BookSnapshot.h"
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+size_t copyLevels(const std::vector<BookLevel>& levels, size_t n, BookLevel* out) {
+    n = std::min(n, levels.size());
+    std::copy_n(levels.begin(), n, out);
+    return n;
+}
+
+} // namespace
+
+BookSnapshot::BookSnapshot(const OrderBook& book, std::uint64_t version) {
+    capture(book, version);
+}
+
+void BookSnapshot::capture(const OrderBook& book, std::uint64_t version) {
+    sequence = version;
+    levelChecksum = book.checksum();
+    bookStats = book.stats();
+    bids.clear();
+    asks.clear();
+    bids.reserve(book.levelCount(Side::Bid));
+    asks.reserve(book.levelCount(Side::Ask));
+    book.forEachBid([this](const PriceLevel& level) { bids.push_back({level.price, level.volume, level.orderCount}); });
+    book.forEachAsk([this](const PriceLevel& level) { asks.push_back({level.price, level.volume, level.orderCount}); });
+}
+
+size_t BookSnapshot::topBids(size_t n, BookLevel* out) const {
+    return copyLevels(bids, n, out);
+}
+
+size_t BookSnapshot::topAsks(size_t n, BookLevel* out) const {
+    return copyLevels(asks, n, out);
+}
+
+SnapshotSlot::SnapshotSlot() {
+    for (size_t i = 0; i < POOL_SIZE; ++i) {
+        nodes.push_back(std::make_unique<Node>());
+        nodes.back()->snapshot = std::make_shared<BookSnapshot>();
+    }
+    current.store(nodes.front().get());
+}
+
+// The pin count and current are both seq_cst, so a writer that sees a node
+// unpinned after replacing it either runs before the reader's pin, whose
+// recheck of current then fails, or sees the pin and leaves the node alone.
+// A reader done copying has raised use_count before unpinning with release.
+void SnapshotSlot::publish(const OrderBook& book) {
+    Node* live = current.load(std::memory_order_relaxed);
+    Node* next = nullptr;
+    for (auto& node : nodes) {
+        if (node.get() == live || node->pins.load() != 0) continue;
+        next = node.get();
+        if (next->snapshot.use_count() == 1) break; // held by no reader either, so it can be refilled
+    }
+    if (next && next->snapshot.use_count() == 1) {
+        // Pairs with the release in the last holder's reference drop
+        std::atomic_thread_fence(std::memory_order_acquire);
+        next->snapshot->capture(book, ++published);
+    } else {
+        if (!next) {
+            nodes.push_back(std::make_unique<Node>());
+            next = nodes.back().get();
+        }
+        next->snapshot = std::make_shared<BookSnapshot>(book, ++published);
+    }
+    current.store(next);
+}
+
+std::shared_ptr<const BookSnapshot> SnapshotSlot::load() const {
+    while (true) {
+        Node* node = current.load();
+        node->pins.fetch_add(1);
+        if (current.load() == node) {
+            std::shared_ptr<const BookSnapshot> snapshot = node->snapshot;
+            node->pins.fetch_sub(1, std::memory_order_release);
+            return snapshot;
+        }
+        node->pins.fetch_sub(1, std::memory_order_release); // a publish landed in between
+    }
+}
@@ -0,0 +1,125 @@
+#include "trading/ConsolidatedBook.h"
+
+ConsolidatedBook::ConsolidatedBook()
+    : arena(std::make_unique<BookArena>()),
+      bids(Side::Bid, arena->resource()),
+      asks(Side::Ask, arena->resource()) {
+    venues.reserve(MAX_VENUES);
+}
+
+VenueId ConsolidatedBook::addVenue(const std::string& name) {
+    if (venues.size() == MAX_VENUES) return NO_VENUE;
+    venues.push_back(name);
+    return static_cast<VenueId>(venues.size() - 1);
+}
+
+bool ConsolidatedBook::applyUpdate(VenueId venue, Side side, Price price, Quantity volume) {
+    if (venue >= venues.size()) return false;
+    Ladder& ladder = side == Side::Bid ? bids : asks;
+    std::uint32_t bit = std::uint32_t(1) << venue;
+
+    if (volume == 0) {
+        ConsolidatedLevel* level = ladder.find(price);
+        if (!level || !(level->venueMask & bit)) return true;
+        level->volume -= level->venueVolumes[venue];
+        level->venueVolumes[venue] = 0;
+        level->venueMask &= ~bit;
+        if (level->venueMask == 0) ladder.erase(price);
+        return true;
+    }
+
+    ConsolidatedLevel& level = ladder.insert(price);
+    level.price = price;
+    level.volume += volume - level.venueVolumes[venue];
+    level.venueVolumes[venue] = volume;
+    level.venueMask |= bit;
+    return true;
+}
+
+bool ConsolidatedBook::syncVenue(VenueId venue, const OrderBook& book) {
+    if (venue >= venues.size()) return false;
+    syncSide(venue, Side::Bid, book);
+    syncSide(venue, Side::Ask, book);
+    return true;
+}
+
+// Merges the venue's levels against the consolidated side best first. The
+// changes are collected before any is applied, since applying one can erase
+// a level the walk has yet to pass.
+void ConsolidatedBook::syncSide(VenueId venue, Side side, const OrderBook& book) {
+    const Ladder& ladder = side == Side::Bid ? bids : asks;
+    auto better = [side](Price a, Price b) { return side == Side::Bid ? a > b : a < b; };
+    std::uint32_t bit = std::uint32_t(1) << venue;
+
+    venueLevels.resize(book.levelCount(side));
+    venueLevels.resize(side == Side::Bid ? book.topBids(venueLevels.size(), venueLevels.data())
+                                         : book.topAsks(venueLevels.size(), venueLevels.data()));
+
+    pending.clear();
+    size_t next = 0;
+    ladder.forEach([&](Price price, const ConsolidatedLevel& level) {
+        for (; next < venueLevels.size() && better(venueLevels[next].price, price); ++next) {
+            pending.push_back({side, venueLevels[next].price, venueLevels[next].volume});
+        }
+        if (next < venueLevels.size() && venueLevels[next].price == price) {
+            if (level.venueVolumes[venue] != venueLevels[next].volume) {
+                pending.push_back({side, price, venueLevels[next].volume});
+            }
+            ++next;
+        } else if (level.venueMask & bit) {
+            pending.push_back({side, price, 0});
+        }
+    });
+    for (; next < venueLevels.size(); ++next) {
+        pending.push_back({side, venueLevels[next].price, venueLevels[next].volume});
+    }
+
+    for (const LevelUpdate& update : pending) {
+        applyUpdate(venue, update.side, update.price, update.volume);
+    }
+}
+
+bool ConsolidatedBook::clearVenue(VenueId venue) {
+    if (venue >= venues.size()) return false;
+    std::uint32_t bit = std::uint32_t(1) << venue;
+    pending.clear();
+    bids.forEach([&](Price price, const ConsolidatedLevel& level) {
+        if (level.venueMask & bit) pending.push_back({Side::Bid, price, 0});
+    });
+    asks.forEach([&](Price price, const ConsolidatedLevel& level) {
+        if (level.venueMask & bit) pending.push_back({Side::Ask, price, 0});
+    });
+    for (const LevelUpdate& update : pending) {
+        applyUpdate(venue, update.side, update.price, 0);
+    }
+    return true;
+}
+
+ConsolidatedQuote ConsolidatedBook::nbbo() const {
+    ConsolidatedQuote quote;
+    if (!bids.empty()) {
+        const ConsolidatedLevel& best = bids.best();
+        quote.bid = bids.bestPrice();
+        quote.bidQty = best.volume;
+        quote.bidVenues = best.venueMask;
+    }
+    if (!asks.empty()) {
+        const ConsolidatedLevel& best = asks.best();
+        quote.ask = asks.bestPrice();
+        quote.askQty = best.volume;
+        quote.askVenues = best.venueMask;
+    }
+    return quote;
+}
+
+size_t ConsolidatedBook::topBids(size_t n, ConsolidatedLevel* out) const {
+    size_t written = 0;
+    bids.forEach([out, &written](Price, const ConsolidatedLevel& level) { out[written++] = level; }, n);
+    return written;
+}
+
+size_t ConsolidatedBook::topAsks(size_t n, ConsolidatedLevel* out) const {
+    size_t written = 0;
+    asks.forEach([out, &written](Price, const ConsolidatedLevel& level) { out[written++] = level; }, n);
+    return written;
+}
@@ -0,0 +1,140 @@
+#include "trading/DepthKernels.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define DEPTH_KERNELS_X86 1
+#endif
+
+namespace {
+
+void cumulativeVolumeScalar(const Quantity* volumes, size_t n, Quantity* out) {
+    Quantity total = 0;
+    for (size_t i = 0; i < n; ++i) {
+        total += volumes[i];
+        out[i] = total;
+    }
+}
+
+size_t levelReachingSizeScalar(const Quantity* volumes, size_t n, Quantity size) {
+    Quantity total = 0;
+    for (size_t i = 0; i < n; ++i) {
+        total += volumes[i];
+        if (total >= size) return i;
+    }
+    return n;
+}
+
+Quantity volumeWithinScalar(const Price* prices, const Quantity* volumes, size_t n, Side side, Price limit) {
+    Quantity total = 0;
+    for (size_t i = 0; i < n && (side == Side::Bid ? prices[i] >= limit : prices[i] <= limit); ++i) {
+        total += volumes[i];
+    }
+    return total;
+}
+
+#ifdef DEPTH_KERNELS_X86
+
+// Running totals of the four lanes of v, plus carry in every lane
+__attribute__((target("avx2"))) __m256i prefixSum4(__m256i v, __m256i carry) {
+    __m256i zero = _mm256_setzero_si256();
+    v = _mm256_add_epi64(v, _mm256_blend_epi32(_mm256_permute4x64_epi64(v, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x03));
+    v = _mm256_add_epi64(v, _mm256_blend_epi32(_mm256_permute4x64_epi64(v, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x0F));
+    return _mm256_add_epi64(v, carry);
+}
+
+__attribute__((target("avx2"))) __m256i lastLane(__m256i v) {
+    return _mm256_permute4x64_epi64(v, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+__attribute__((target("avx2"))) void cumulativeVolumeAvx2(const Quantity* volumes, size_t n, Quantity* out) {
+    __m256i carry = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i sums = prefixSum4(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(volumes + i)), carry);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), sums);
+        carry = lastLane(sums);
+    }
+    Quantity total = i ? out[i - 1] : 0;
+    for (; i < n; ++i) {
+        total += volumes[i];
+        out[i] = total;
+    }
+}
+
+__attribute__((target("avx2"))) size_t levelReachingSizeAvx2(const Quantity* volumes, size_t n, Quantity size) {
+    __m256i carry = _mm256_setzero_si256();
+    __m256i threshold = _mm256_set1_epi64x(size - 1);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i sums = prefixSum4(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(volumes + i)), carry);
+        int reached = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(sums, threshold)));
+        if (reached) return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(reached)));
+        carry = lastLane(sums);
+    }
+    Quantity total = _mm256_extract_epi64(carry, 0);
+    for (; i < n; ++i) {
+        total += volumes[i];
+        if (total >= size) return i;
+    }
+    return n;
+}
+
+__attribute__((target("avx2"))) Quantity volumeWithinAvx2(const Price* prices, const Quantity* volumes, size_t n,
+                                                          Side side, Price limit) {
+    // Prices are sorted best first, so the first block with a level past
+    // limit is the last one that contributes
+    __m256i bound = _mm256_set1_epi64x(side == Side::Bid ? limit - 1 : limit + 1);
+    __m256i sums = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prices + i));
+        __m256i inside = side == Side::Bid ? _mm256_cmpgt_epi64(p, bound) : _mm256_cmpgt_epi64(bound, p);
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(volumes + i));
+        sums = _mm256_add_epi64(sums, _mm256_and_si256(v, inside));
+        if (_mm256_movemask_pd(_mm256_castsi256_pd(inside)) != 0xF) {
+            n = i; // nothing past this block is inside
+            break;
+        }
+    }
+    __m128i pair = _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+    Quantity total = _mm_cvtsi128_si64(pair) + _mm_extract_epi64(pair, 1);
+    return total + volumeWithinScalar(prices + i, volumes + i, n - i, side, limit);
+}
+
+#endif
+
+bool hasAvx2() {
+#ifdef DEPTH_KERNELS_X86
+    static const bool supported = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+    return supported;
+#else
+    return false;
+#endif
+}
+
+} // namespace
+
+void cumulativeVolume(const Quantity* volumes, size_t n, Quantity* out) {
+#ifdef DEPTH_KERNELS_X86
+    if (hasAvx2()) return cumulativeVolumeAvx2(volumes, n, out);
+#endif
+    cumulativeVolumeScalar(volumes, n, out);
+}
+
+size_t levelReachingSize(const Quantity* volumes, size_t n, Quantity size) {
+#ifdef DEPTH_KERNELS_X86
+    if (hasAvx2()) return levelReachingSizeAvx2(volumes, n, size);
+#endif
+    return levelReachingSizeScalar(volumes, n, size);
+}
+
+Quantity volumeWithin(const Price* prices, const Quantity* volumes, size_t n, Side side, Price limit) {
+#ifdef DEPTH_KERNELS_X86
+    if (hasAvx2()) return volumeWithinAvx2(prices, volumes, n, side, limit);
+#endif
+    return volumeWithinScalar(prices, volumes, n, side, limit);
+}
+
+bool depthKernelsUseAvx2() {
+    return hasAvx2();
+}
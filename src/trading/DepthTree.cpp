@@ -0,0 +1,62 @@
+#include "trading/DepthTree.h"
+
+DepthTree::DepthTree(std::pmr::memory_resource* resource) : volumes(resource), weighted(resource), counts(resource) {}
+
+void DepthTree::reset(size_t slots) {
+    volumes.assign(slots + 1, 0);
+    weighted.assign(slots + 1, 0);
+    counts.assign(slots + 1, 0);
+    for (topStep = 1; topStep * 2 <= slots; topStep *= 2) {}
+}
+
+void DepthTree::seed(size_t slot, Quantity volume) {
+    volumes[slot + 1] = volume;
+    weighted[slot + 1] = volume * static_cast<Quantity>(slot);
+    counts[slot + 1] = volume != 0;
+}
+
+// Pushes every node's partial sum into its parent, turning seeded values into a tree
+void DepthTree::finish() {
+    for (size_t i = 1; i < volumes.size(); ++i) {
+        size_t parent = i + (i & (~i + 1));
+        if (parent < volumes.size()) {
+            volumes[parent] += volumes[i];
+            weighted[parent] += weighted[i];
+            counts[parent] += counts[i];
+        }
+    }
+}
+
+void DepthTree::add(size_t slot, Quantity volume, int levels) {
+    Quantity weight = volume * static_cast<Quantity>(slot);
+    for (size_t i = slot + 1; i < volumes.size(); i += i & (~i + 1)) {
+        volumes[i] += volume;
+        weighted[i] += weight;
+        counts[i] += static_cast<std::uint32_t>(levels);
+    }
+}
+
+// Fenwick descent: extends the run by halving steps while keep(node) holds
+template <typename Keep>
+DepthTree::Prefix DepthTree::descend(Keep&& keep) const {
+    Prefix prefix{0, 0, 0, 0};
+    size_t slots = volumes.empty() ? 0 : volumes.size() - 1;
+    for (size_t step = slots ? topStep : 0; step > 0; step /= 2) {
+        size_t next = prefix.slots + step;
+        if (next <= slots && keep(prefix, next)) {
+            prefix.slots = next;
+            prefix.levels += counts[next];
+            prefix.volume += volumes[next];
+            prefix.weighted += weighted[next];
+        }
+    }
+    return prefix;
+}
+
+DepthTree::Prefix DepthTree::below(Quantity size) const {
+    return descend([this, size](const Prefix& prefix, size_t node) { return prefix.volume + volumes[node] < size; });
+}
+
+DepthTree::Prefix DepthTree::first(size_t levels) const {
+    return descend([this, levels](const Prefix& prefix, size_t node) { return prefix.levels + counts[node] <= levels; });
+}
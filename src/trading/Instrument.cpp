@@ -0,0 +1,27 @@
+#include "trading/Instrument.h"
+#include <unordered_map>
+
+namespace {
+
+const InstrumentSpec DEFAULT_SPEC{0.00000001, 0.00000001};
+
+// symbol -> {tick size, lot size}
+const std::unordered_map<std::string, InstrumentSpec> INSTRUMENT_SPECS = {
+    {"btcusd",  {0.01,    0.00000001}},
+    {"ethusd",  {0.01,    0.00000001}},
+    {"ltcusd",  {0.01,    0.00000001}},
+    {"bchusd",  {0.01,    0.00000001}},
+    {"solusd",  {0.001,   0.00000001}},
+    {"linkusd", {0.001,   0.00000001}},
+    {"dotusd",  {0.001,   0.00000001}},
+    {"dogeusd", {0.00001, 0.00000001}},
+    {"xrpusd",  {0.00001, 0.00000001}},
+    {"adausd",  {0.00001, 0.00000001}},
+};
+
+} // namespace
+
+const InstrumentSpec& getInstrumentSpec(const std::string& symbol) {
+    auto it = INSTRUMENT_SPECS.find(symbol);
+    return it != INSTRUMENT_SPECS.end() ? it->second : DEFAULT_SPEC;
+}
@@ -1,3 +1,3 @@
 #include "trading/Order.h"
 
-Order::Order(double p, double v) : price(p), volume(v) {}
+Order::Order(Price p, Quantity v, OrderId i) : price(p), volume(v), id(i) {}
@@ -1,93 +1,766 @@
 #include "trading/OrderBook.h"
 #include <algorithm>
-#include <json.hpp>
+#include <cmath>
+#include "trading/DepthKernels.h"
 
-void OrderBook::addBid(double price, double volume) {
-    bids[price].emplace_back(price, volume);
+namespace {
+
+// Whether an incoming order is willing to trade with a resting price
+bool crosses(const OrderRequest& request, Price restingPrice) {
+    if (request.type == OrderType::Market) return true;
+    return request.side == Side::Bid ? request.price >= restingPrice : request.price <= restingPrice;
 }
 
-void OrderBook::addAsk(double price, double volume) {
-    asks[price].emplace_back(price, volume);
+// splitmix64 finaliser over one level; an empty level hashes to 0 so it
+// drops out of the XOR
+std::uint64_t levelHash(Side side, Price price, Quantity volume) {
+    if (volume == 0) return 0;
+    std::uint64_t h = static_cast<std::uint64_t>(price) * 0x9e3779b97f4a7c15ULL;
+    h ^= static_cast<std::uint64_t>(volume) + (side == Side::Bid ? 0x632be59bd9b4e019ULL : 0x85ebca77c2b2ae63ULL) + (h << 6) + (h >> 2);
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    return h ^ (h >> 31);
 }
 
-double OrderBook::bestBid() const {
-    return bids.empty() ? -1.0 : bids.rbegin()->first;
+} // namespace
+
+OrderBook::OrderBook(BookMode mode)
+    : mode(mode),
+      arena(std::make_unique<BookArena>()),
+      bids(Side::Bid, arena->resource()),
+      asks(Side::Ask, arena->resource()),
+      orderPool(arena->resource()),
+      orderIndex(arena->resource()),
+      staleLevels(arena->resource()),
+      bidColumns(arena->resource()),
+      askColumns(arena->resource()),
+      bidTree(arena->resource()),
+      askTree(arena->resource()) {}
+
+OrderBook::OrderBook(const OrderBook& other)
+    : mode(other.mode),
+      aggressor(other.aggressor),
+      nextOrderId(other.nextOrderId),
+      freeOrders(other.freeOrders),
+      arena(std::make_unique<BookArena>()),
+      bids(other.bids, arena->resource()),
+      asks(other.asks, arena->resource()),
+      orderPool(other.orderPool, arena->resource()),
+      orderIndex(other.orderIndex, arena->resource()),
+      staleLevels(arena->resource()),
+      bidColumns(arena->resource()),
+      askColumns(arena->resource()),
+      bidTree(arena->resource()),
+      askTree(arena->resource()),
+      bidChecksum(other.bidChecksum),
+      askChecksum(other.askChecksum) {
+    noteDepth();
 }
 
-double OrderBook::bestAsk() const {
-    return asks.empty() ? -1.0 : asks.begin()->first;
+// pmr containers never adopt another arena on assignment, so levels are
+// copied or moved into this book's arena and the old one is left untouched
+OrderBook& OrderBook::operator=(const OrderBook& other) {
+    mode = other.mode;
+    aggressor = other.aggressor;
+    nextOrderId = other.nextOrderId;
+    freeOrders = other.freeOrders;
+    bids = other.bids;
+    asks = other.asks;
+    orderPool = other.orderPool;
+    orderIndex = other.orderIndex;
+    bidChecksum = other.bidChecksum;
+    askChecksum = other.askChecksum;
+    bidColumns.version = askColumns.version = UINT64_MAX;
+    bidTree.layout = askTree.layout = DepthTree::NO_LAYOUT;
+    bidTop.version = askTop.version = UINT64_MAX;
+    noteDepth();
+    return *this;
 }
 
-bool OrderBook::matchOrders() {
-    while (!bids.empty() && !asks.empty()) {
-        auto bestBidIt = std::prev(bids.end());
-        auto bestAskIt = asks.begin();
+OrderBook& OrderBook::operator=(OrderBook&& other) {
+    mode = other.mode;
+    aggressor = other.aggressor;
+    nextOrderId = other.nextOrderId;
+    freeOrders = other.freeOrders;
+    bids = std::move(other.bids);
+    asks = std::move(other.asks);
+    orderPool = std::move(other.orderPool);
+    orderIndex = std::move(other.orderIndex);
+    bidChecksum = other.bidChecksum;
+    askChecksum = other.askChecksum;
+    bidColumns.version = askColumns.version = UINT64_MAX;
+    bidTree.layout = askTree.layout = DepthTree::NO_LAYOUT;
+    bidTop.version = askTop.version = UINT64_MAX;
+    noteDepth();
+    return *this;
+}
+
+OrderId OrderBook::addBid(Price price, Quantity volume) {
+    if (volume <= 0) return 0;
+    if (mode == BookMode::L3) ++counters.orderEvents;
+    noteAggressor(Side::Bid, price);
+    return addToLevel(Side::Bid, price, volume, mode == BookMode::L3 ? assignId() : 0);
+}
+
+OrderId OrderBook::addAsk(Price price, Quantity volume) {
+    if (volume <= 0) return 0;
+    if (mode == BookMode::L3) ++counters.orderEvents;
+    noteAggressor(Side::Ask, price);
+    return addToLevel(Side::Ask, price, volume, mode == BookMode::L3 ? assignId() : 0);
+}
+
+bool OrderBook::addOrder(OrderId id, Side side, Price price, Quantity volume) {
+    if (mode != BookMode::L3 || id == 0 || volume <= 0 || orderIndex.find(id) != OrderIndex::NONE) return false;
+    ++counters.orderEvents;
+    noteAggressor(side, price);
+    addToLevel(side, price, volume, id);
+    return true;
+}
 
-        if (bestBidIt->first < bestAskIt->first) break;
+OrderId OrderBook::addToLevel(Side side, Price price, Quantity volume, OrderId id) {
+    if (volume <= 0) return 0; // never rest an empty or negative order
+    PriceLevel& level = ladderFor(side).insert(price);
+    level.price = price;
+    if (mode == BookMode::L3) {
+        linkOrder(level, side, id, price, volume);
+    } else {
+        setLevelVolume(ladderFor(side), level, level.volume + volume);
+        ++level.orderCount;
+    }
+    noteDepth();
+    return id;
+}
 
-        auto& bidQueue = bestBidIt->second;
-        auto& askQueue = bestAskIt->second;
+bool OrderBook::cancelOrder(OrderId id) {
+    std::uint32_t slot = orderIndex.find(id);
+    if (slot == OrderIndex::NONE) return false;
+    ++counters.orderEvents;
+
+    Ladder& ladder = ladderFor(orderPool[slot].side);
+    Price price = orderPool[slot].price;
+    PriceLevel& level = *ladder.find(price);
+    unlinkOrder(level, slot);
+    if (level.orderCount == 0) ladder.erase(price);
+    return true;
+}
 
-        Order& bid = bidQueue.front();
-        Order& ask = askQueue.front();
+bool OrderBook::reduceOrder(OrderId id, Quantity volume) {
+    if (volume <= 0) return false; // a reduction never grows an order
+    std::uint32_t slot = orderIndex.find(id);
+    if (slot == OrderIndex::NONE) return false;
 
-        double tradeVolume = std::min(bid.volume, ask.volume);
-        bid.volume -= tradeVolume;
-        ask.volume -= tradeVolume;
+    RestingOrder& order = orderPool[slot];
+    if (volume >= order.volume) return cancelOrder(id);
 
-        if (bid.volume == 0) bidQueue.pop_front();
-        if (ask.volume == 0) askQueue.pop_front();
+    ++counters.orderEvents;
+    order.volume -= volume;
+    Ladder& ladder = ladderFor(order.side);
+    PriceLevel& level = *ladder.find(order.price);
+    setLevelVolume(ladder, level, level.volume - volume);
+    return true;
+}
 
-        if (bidQueue.empty()) bids.erase(bestBidIt);
-        if (askQueue.empty()) asks.erase(bestAskIt);
+bool OrderBook::replaceOrder(OrderId id, Price price, Quantity volume) {
+    std::uint32_t slot = orderIndex.find(id);
+    if (slot == OrderIndex::NONE) return false;
+    if (volume <= 0) return cancelOrder(id);
 
-        return true; // one match done
+    const RestingOrder& order = orderPool[slot];
+    if (price == order.price && volume == order.volume) return true;
+    if (price == order.price && volume < order.volume) {
+        return reduceOrder(id, order.volume - volume);
     }
-    return false;
+
+    Side side = order.side;
+    cancelOrder(id); // counted as the replace
+    noteAggressor(side, price);
+    addToLevel(side, price, volume, id);
+    return true;
 }
 
-void OrderBook::setOrderBook(const nlohmann::json& json) {
-    bids.clear();
-    asks.clear();
+const RestingOrder* OrderBook::findOrder(OrderId id) const {
+    std::uint32_t slot = orderIndex.find(id);
+    return slot == OrderIndex::NONE ? nullptr : &orderPool[slot];
+}
 
-    if (json.contains("bids") && json["bids"].is_array()) {
-        for (const auto& entry : json["bids"]) {
-            if (entry.size() >= 2) {
-                double price = entry[0].get<double>();
-                double volume = entry[1].get<double>();
-                bids[price].emplace_back(price, volume);
-            }
+// Next id from the assigned range that no resting order holds; addOrder and
+// submit accept any caller id, including ones from this range
+OrderId OrderBook::assignId() {
+    while (nextOrderId == 0 || orderIndex.find(nextOrderId) != OrderIndex::NONE) ++nextOrderId;
+    return nextOrderId++;
+}
+
+// Appends an order to the back of a level's queue; id must not be resting
+void OrderBook::linkOrder(PriceLevel& level, Side side, OrderId id, Price price, Quantity volume) {
+    std::uint32_t slot;
+    if (freeOrders != NO_ORDER) {
+        slot = freeOrders;
+        freeOrders = orderPool[slot].next;
+    } else {
+        slot = static_cast<std::uint32_t>(orderPool.size());
+        orderPool.emplace_back();
+    }
+
+    orderPool[slot] = {id, price, volume, level.tail, NO_ORDER, side};
+    if (level.tail != NO_ORDER) {
+        orderPool[level.tail].next = slot;
+    } else {
+        level.head = slot;
+    }
+    level.tail = slot;
+    setLevelVolume(ladderFor(side), level, level.volume + volume);
+    ++level.orderCount;
+    orderIndex.insert(id, slot);
+}
+
+// Removes an order from its level's queue and returns its slot to the pool
+void OrderBook::unlinkOrder(PriceLevel& level, std::uint32_t slot) {
+    RestingOrder& order = orderPool[slot];
+    if (order.prev != NO_ORDER) {
+        orderPool[order.prev].next = order.next;
+    } else {
+        level.head = order.next;
+    }
+    if (order.next != NO_ORDER) {
+        orderPool[order.next].prev = order.prev;
+    } else {
+        level.tail = order.prev;
+    }
+    setLevelVolume(ladderFor(order.side), level, level.volume - order.volume);
+    --level.orderCount;
+
+    orderIndex.erase(order.id);
+    order.next = freeOrders;
+    freeOrders = slot;
+}
+
+// Frees a whole chain of orders; the caller resets the level itself
+void OrderBook::releaseOrders(std::uint32_t head) {
+    while (head != NO_ORDER) {
+        RestingOrder& order = orderPool[head];
+        std::uint32_t next = order.next;
+        orderIndex.erase(order.id);
+        order.next = freeOrders;
+        freeOrders = head;
+        head = next;
+    }
+}
+
+// Every change to a level's volume goes through here so the depth trees and
+// checksum follow it. A tree built for an older window layout is left alone;
+// it is rebuilt from the levels on its next query.
+void OrderBook::setLevelVolume(Ladder& ladder, PriceLevel& level, Quantity volume) {
+    bool bid = &ladder == &bids;
+    DepthTree& tree = bid ? bidTree : askTree;
+    size_t slot = ladder.slotOf(level.price);
+    if (tree.layout == ladder.layout() && slot < ladder.windowSize()) {
+        tree.add(slot, volume - level.volume, (volume != 0) - (level.volume != 0));
+    }
+    Side side = bid ? Side::Bid : Side::Ask;
+    (bid ? bidChecksum : askChecksum) ^= levelHash(side, level.price, level.volume) ^ levelHash(side, level.price, volume);
+    level.volume = volume;
+}
+
+void OrderBook::eraseLevel(Ladder& ladder, Price price) {
+    PriceLevel* level = ladder.find(price);
+    if (!level) return;
+    if (mode == BookMode::L3) releaseOrders(level->head);
+    setLevelVolume(ladder, *level, 0);
+    ladder.erase(price);
+}
+
+void OrderBook::clearSide(Ladder& ladder) {
+    if (mode == BookMode::L3) {
+        ladder.forEach([this](Price, const PriceLevel& level) { releaseOrders(level.head); });
+    }
+    ladder.clear();
+    (&ladder == &bids ? bidChecksum : askChecksum) = 0;
+}
+
+std::uint64_t OrderBook::recomputeChecksum() const {
+    std::uint64_t hash = 0;
+    bids.forEach([&hash](Price price, const PriceLevel& level) { hash ^= levelHash(Side::Bid, price, level.volume); });
+    asks.forEach([&hash](Price price, const PriceLevel& level) { hash ^= levelHash(Side::Ask, price, level.volume); });
+    return hash;
+}
+
+Price OrderBook::bestBid() const {
+    return bids.bestPrice();
+}
+
+Price OrderBook::bestAsk() const {
+    return asks.bestPrice();
+}
+
+// L2 levels trade as a whole, L3 levels front order first; traded is what
+// has come off the level since it was last settled
+Quantity OrderBook::frontVolume(const PriceLevel& level, Quantity traded) const {
+    return mode == BookMode::L2 ? level.volume - traded : orderPool[level.head].volume;
+}
+
+bool OrderBook::matchOrders() {
+    Fill fill;
+    return matchOnce(fill); // one match done
+}
+
+// Holds the best level of each side and walks their queues against each
+// other. A level is settled once, when it runs out or the book uncrosses,
+// and only then is the next best level on that side fetched.
+size_t OrderBook::match(FillSink& sink) {
+    if (bids.empty() || asks.empty() || bids.bestPrice() < asks.bestPrice()) return 0;
+
+    size_t count = 0;
+    PriceLevel* bid = &bids.best();
+    PriceLevel* ask = &asks.best();
+    Quantity bidTraded = 0;
+    Quantity askTraded = 0;
+    while (true) {
+        Quantity tradeVolume = std::min(frontVolume(*bid, bidTraded), frontVolume(*ask, askTraded));
+        OrderId bidId = takeFront(*bid, tradeVolume);
+        OrderId askId = takeFront(*ask, tradeVolume);
+        bidTraded += tradeVolume;
+        askTraded += tradeVolume;
+        sink.push({bid->price, ask->price, tradeVolume, aggressor, bidId, askId});
+        ++count;
+
+        if (bidTraded == bid->volume) {
+            settleLevel(bids, *bid, bidTraded);
+            bidTraded = 0;
+            bid = bids.empty() ? nullptr : &bids.best();
+        }
+        if (askTraded == ask->volume) {
+            settleLevel(asks, *ask, askTraded);
+            askTraded = 0;
+            ask = asks.empty() ? nullptr : &asks.best();
         }
+        if (!bid || !ask || bid->price < ask->price) break;
     }
+    if (bidTraded > 0) settleLevel(bids, *bid, bidTraded);
+    if (askTraded > 0) settleLevel(asks, *ask, askTraded);
+    counters.fills += count;
+    return count;
+}
+
+bool OrderBook::matchOnce(Fill& fill) {
+    if (bids.empty() || asks.empty()) return false;
+
+    Price bidPrice = bids.bestPrice();
+    Price askPrice = asks.bestPrice();
+    if (bidPrice < askPrice) return false;
 
-    if (json.contains("asks") && json["asks"].is_array()) {
-        for (const auto& entry : json["asks"]) {
-            if (entry.size() >= 2) {
-                double price = entry[0].get<double>();
-                double volume = entry[1].get<double>();
-                asks[price].emplace_back(price, volume);
+    PriceLevel& bid = bids.best();
+    PriceLevel& ask = asks.best();
+    Quantity tradeVolume = std::min(frontVolume(bid, 0), frontVolume(ask, 0));
+    OrderId bidId = takeFront(bid, tradeVolume);
+    OrderId askId = takeFront(ask, tradeVolume);
+    settleLevel(bids, bid, tradeVolume);
+    settleLevel(asks, ask, tradeVolume);
+
+    fill = {bidPrice, askPrice, tradeVolume, aggressor, bidId, askId};
+    ++counters.fills;
+    return true;
+}
+
+SubmitResult OrderBook::submit(const OrderRequest& request, FillSink& sink) {
+    Ladder& resting = ladderFor(request.side == Side::Bid ? Side::Ask : Side::Bid);
+    bool rests = request.type == OrderType::Limit || request.type == OrderType::PostOnly;
+    OrderId id = mode == BookMode::L3 ? (request.id ? request.id : assignId()) : 0;
+    ++counters.orderEvents;
+
+    if (request.volume <= 0 || (request.type != OrderType::Market && request.price < 0)) {
+        return {OrderStatus::Rejected, 0, request.volume, id};
+    }
+    if (mode == BookMode::L3 && orderIndex.find(id) != OrderIndex::NONE) {
+        return {OrderStatus::Rejected, 0, request.volume, id};
+    }
+    if (request.type == OrderType::PostOnly && !resting.empty() && crosses(request, resting.bestPrice())) {
+        return {OrderStatus::Rejected, 0, request.volume, id};
+    }
+    if (request.type == OrderType::FillOrKill && liquidityUpTo(resting, request) < request.volume) {
+        return {OrderStatus::Cancelled, 0, request.volume, id};
+    }
+
+    // Sweeps one level at a time, settling its totals once the order is done with it
+    Quantity remaining = request.volume;
+    while (remaining > 0 && !resting.empty() && crosses(request, resting.bestPrice())) {
+        Price restingPrice = resting.bestPrice();
+        Price incomingPrice = request.type == OrderType::Market ? restingPrice : request.price;
+        PriceLevel& level = resting.best();
+        Quantity traded = 0;
+        while (remaining > 0 && traded < level.volume) {
+            Quantity tradeVolume = std::min(remaining, frontVolume(level, traded));
+            OrderId restingId = takeFront(level, tradeVolume);
+            traded += tradeVolume;
+            remaining -= tradeVolume;
+
+            ++counters.fills;
+            if (request.side == Side::Bid) {
+                sink.push({incomingPrice, restingPrice, tradeVolume, Side::Bid, id, restingId});
+            } else {
+                sink.push({restingPrice, incomingPrice, tradeVolume, Side::Ask, restingId, id});
             }
         }
+        settleLevel(resting, level, traded);
     }
+
+    Quantity filled = request.volume - remaining;
+    if (remaining == 0) return {OrderStatus::Filled, filled, 0, id};
+    if (!rests) return {OrderStatus::Cancelled, filled, remaining, id};
+
+    addToLevel(request.side, request.price, remaining, id);
+    return {OrderStatus::Resting, filled, remaining, id};
 }
 
-std::vector<Order> OrderBook::getBids() const {
-    std::vector<Order> allBids;
-    for (auto it = bids.rbegin(); it != bids.rend(); ++it) { // Highest price first
-        for (const auto& order : it->second) {
-            allBids.push_back(order);
+// Volume an incoming order could trade right now, counting only as far as it needs
+Quantity OrderBook::liquidityUpTo(const Ladder& resting, const OrderRequest& request) const {
+    Quantity total = 0;
+    for (auto it = resting.begin(); it != resting.end() && total < request.volume && crosses(request, it.price()); ++it) {
+        total += it->volume;
+    }
+    return total;
+}
+
+// Trades volume off a level's front order and frees the order once it is used
+// up. The level's volume is left to settleLevel, so a sweep pays for the
+// checksum and depth tree once per level rather than once per fill. Returns
+// the traded order's id (0 for L2).
+OrderId OrderBook::takeFront(PriceLevel& level, Quantity volume) {
+    if (mode == BookMode::L2) return 0;
+
+    std::uint32_t slot = level.head;
+    RestingOrder& front = orderPool[slot];
+    OrderId id = front.id;
+    if (front.volume > volume) {
+        front.volume -= volume;
+        return id;
+    }
+    level.head = front.next;
+    if (front.next != NO_ORDER) {
+        orderPool[front.next].prev = NO_ORDER;
+    } else {
+        level.tail = NO_ORDER;
+    }
+    --level.orderCount;
+    orderIndex.erase(id);
+    front.next = freeOrders;
+    freeOrders = slot;
+    return id;
+}
+
+// Takes what a sweep traded off the level's total and removes the level once it is empty
+void OrderBook::settleLevel(Ladder& ladder, PriceLevel& level, Quantity traded) {
+    Price price = level.price;
+    setLevelVolume(ladder, level, level.volume - traded);
+    if (level.volume == 0) ladder.erase(price);
+}
+
+void OrderBook::noteAggressor(Side side, Price price) {
+    Price opposite = side == Side::Bid ? asks.bestPrice() : bids.bestPrice();
+    bool crossed = opposite >= 0 && (side == Side::Bid ? price >= opposite : price <= opposite);
+    if (crossed) aggressor = side;
+}
+
+void OrderBook::applyUpdate(Side side, Price price, Quantity volume) {
+    ++counters.levelUpdates;
+    Ladder& ladder = ladderFor(side);
+    if (volume == 0) {
+        eraseLevel(ladder, price);
+        return;
+    }
+
+    noteAggressor(side, price);
+    PriceLevel& level = ladder.insert(price);
+    level.price = price;
+    if (mode == BookMode::L2) {
+        setLevelVolume(ladder, level, volume);
+        level.orderCount = 1;
+    } else if (level.orderCount == 1) {
+        orderPool[level.head].volume = volume;
+        setLevelVolume(ladder, level, volume);
+    } else {
+        releaseOrders(level.head);
+        setLevelVolume(ladder, level, 0);
+        level.clear();
+        linkOrder(level, side, assignId(), price, volume);
+    }
+    noteDepth();
+}
+
+void OrderBook::applyBatch(const std::vector<LevelUpdate>& updates) {
+    for (const auto& update : updates) {
+        applyUpdate(update.side, update.price, update.volume);
+    }
+}
+
+void OrderBook::setOrderBook(const std::vector<Order>& newBids, const std::vector<Order>& newAsks) {
+    ++counters.snapshots;
+    syncSide(bids, newBids);
+    syncSide(asks, newAsks);
+    noteDepth();
+}
+
+BookStats OrderBook::stats() const {
+    BookStats stats = counters;
+    stats.bidLevels = bids.size();
+    stats.askLevels = asks.size();
+    stats.restingOrders = orderIndex.size();
+    stats.memory = arena->stats();
+    return stats;
+}
+
+void OrderBook::syncSide(Ladder& ladder, const std::vector<Order>& levels) {
+    Side side = &ladder == &bids ? Side::Bid : Side::Ask;
+    auto better = [side](Price a, Price b) { return side == Side::Bid ? a > b : a < b; };
+
+    if (!std::is_sorted(levels.begin(), levels.end(),
+                        [&better](const Order& a, const Order& b) { return better(a.price, b.price); })) {
+        // Unordered snapshot: fall back to a full rebuild
+        clearSide(ladder);
+        for (const auto& level : levels) {
+            addToLevel(side, level.price, level.volume, mode == BookMode::L3 ? assignId() : 0);
         }
+        return;
+    }
+
+    // Both sides are best first, so one merge pass finds the levels that disappeared
+    staleLevels.clear();
+    size_t next = 0;
+    ladder.forEach([&](Price price, const PriceLevel&) {
+        while (next < levels.size() && better(levels[next].price, price)) ++next;
+        if (next == levels.size() || levels[next].price != price) staleLevels.push_back(price);
+    });
+    for (Price price : staleLevels) {
+        eraseLevel(ladder, price);
+    }
+
+    // Rewrite only the levels that changed; repeated prices share a level.
+    // Entries that are not positive are dropped, as addToLevel drops them in
+    // the unordered path, and a price left with none is removed.
+    for (size_t first = 0; first < levels.size();) {
+        size_t last = first;
+        Quantity total = 0;
+        std::uint32_t count = 0;
+        for (; last < levels.size() && levels[last].price == levels[first].price; ++last) {
+            if (levels[last].volume <= 0) continue;
+            total += levels[last].volume;
+            ++count;
+        }
+        if (count == 0) {
+            eraseLevel(ladder, levels[first].price);
+            first = last;
+            continue;
+        }
+
+        PriceLevel& level = ladder.insert(levels[first].price);
+        bool changed = level.volume != total || level.orderCount != count;
+        if (mode == BookMode::L3) {
+            std::uint32_t slot = level.head;
+            for (size_t i = first; !changed && i < last; ++i) {
+                if (levels[i].volume <= 0) continue;
+                changed = orderPool[slot].volume != levels[i].volume;
+                slot = orderPool[slot].next;
+            }
+        }
+        if (changed) {
+            level.price = levels[first].price;
+            if (mode == BookMode::L3) {
+                releaseOrders(level.head);
+                setLevelVolume(ladder, level, 0);
+                level.clear();
+                for (size_t i = first; i < last; ++i) {
+                    if (levels[i].volume > 0) linkOrder(level, side, assignId(), levels[i].price, levels[i].volume);
+                }
+            } else {
+                setLevelVolume(ladder, level, total);
+                level.orderCount = count;
+            }
+        }
+        first = last;
     }
-    return allBids;
+}
+
+std::vector<Order> OrderBook::getBids() const {
+    return collect(bids); // Highest price first
 }
 
 std::vector<Order> OrderBook::getAsks() const {
-    std::vector<Order> allAsks;
-    for (const auto& [price, queue] : asks) { // Lowest price first
-        for (const auto& order : queue) {
-            allAsks.push_back(order);
+    return collect(asks); // Lowest price first
+}
+
+std::vector<Order> OrderBook::collect(const Ladder& ladder) const {
+    std::vector<Order> orders;
+    ladder.forEach([this, &orders](Price price, const PriceLevel& level) {
+        if (mode == BookMode::L2) {
+            orders.emplace_back(price, level.volume);
+            return;
         }
+        for (std::uint32_t slot = level.head; slot != NO_ORDER; slot = orderPool[slot].next) {
+            const RestingOrder& order = orderPool[slot];
+            orders.emplace_back(order.price, order.volume, order.id);
+        }
+    });
+    return orders;
+}
+
+size_t OrderBook::topBids(size_t n, BookLevel* out) const {
+    return copyTop(bids, n, out);
+}
+
+size_t OrderBook::topAsks(size_t n, BookLevel* out) const {
+    return copyTop(asks, n, out);
+}
+
+size_t OrderBook::copyTop(const Ladder& ladder, size_t n, BookLevel* out) {
+    size_t written = 0;
+    ladder.forEach([out, &written](Price price, const PriceLevel& level) {
+        out[written++] = {price, level.volume, level.orderCount};
+    }, n);
+    return written;
+}
+
+size_t OrderBook::cumulativeDepth(Side side, size_t n, Quantity* out) const {
+    const DepthColumns& columns = depthColumns(side);
+    n = std::min(n, columns.volumes.size());
+    cumulativeVolume(columns.volumes.data(), n, out);
+    return n;
+}
+
+Price OrderBook::priceForSize(Side side, Quantity size) const {
+    const DepthColumns& columns = depthColumns(side);
+    size_t level = levelReachingSize(columns.volumes.data(), columns.volumes.size(), size);
+    return level < columns.prices.size() ? columns.prices[level] : -1;
+}
+
+Quantity OrderBook::depthWithinBps(Side side, double bps) const {
+    if (bids.empty() || asks.empty()) return 0;
+
+    double mid = (bids.bestPrice() + asks.bestPrice()) / 2.0;
+    double offset = mid * bps / 10000.0;
+    Price limit = side == Side::Bid ? static_cast<Price>(std::ceil(mid - offset))
+                                    : static_cast<Price>(std::floor(mid + offset));
+
+    const DepthColumns& columns = depthColumns(side);
+    return volumeWithin(columns.prices.data(), columns.volumes.data(), columns.prices.size(), side, limit);
+}
+
+const OrderBook::DepthColumns& OrderBook::depthColumns(Side side) const {
+    const Ladder& ladder = side == Side::Bid ? bids : asks;
+    DepthColumns& columns = side == Side::Bid ? bidColumns : askColumns;
+    if (columns.version == ladder.version()) return columns;
+
+    columns.prices.resize(ladder.size());
+    columns.volumes.resize(ladder.size());
+    Price* prices = columns.prices.data();
+    Quantity* volumes = columns.volumes.data();
+    ladder.forEach([&prices, &volumes](Price price, const PriceLevel& level) {
+        *prices++ = price;
+        *volumes++ = level.volume;
+    });
+    columns.version = ladder.version();
+    return columns;
+}
+
+double OrderBook::costToFill(Side side, Quantity size) const {
+    if (size <= 0) return 0;
+
+    const Ladder& ladder = side == Side::Bid ? bids : asks;
+    DepthTree::Prefix prefix = depthTree(side).below(size);
+
+    // Slot i is priced slotPrice(0) -/+ i, so the run's notional follows from its two sums
+    double cost = static_cast<double>(ladder.slotPrice(0)) * static_cast<double>(prefix.volume)
+                + (side == Side::Bid ? -1.0 : 1.0) * static_cast<double>(prefix.weighted);
+    Quantity remaining = size - prefix.volume;
+    if (prefix.slots < ladder.windowSize()) {
+        return cost + static_cast<double>(ladder.slotPrice(prefix.slots)) * static_cast<double>(remaining);
+    }
+
+    // The window ran out; only the levels far behind it are left
+    ladder.forEachOverflow([&cost, &remaining](Price price, const PriceLevel& level) {
+        Quantity taken = std::min(remaining, level.volume);
+        cost += static_cast<double>(price) * static_cast<double>(taken);
+        remaining -= taken;
+    });
+    return remaining > 0 ? -1 : cost;
+}
+
+double OrderBook::vwapForSize(Side side, Quantity size) const {
+    if (size <= 0) return -1;
+    double cost = costToFill(side, size);
+    return cost < 0 ? -1 : cost / static_cast<double>(size);
+}
+
+double OrderBook::mid() const {
+    if (bids.empty() || asks.empty()) return -1;
+    return (static_cast<double>(bids.bestPrice()) + static_cast<double>(asks.bestPrice())) / 2.0;
+}
+
+double OrderBook::microprice() const {
+    if (bids.empty() || asks.empty()) return -1;
+    double bidVolume = static_cast<double>(bids.best().volume);
+    double askVolume = static_cast<double>(asks.best().volume);
+    if (bidVolume + askVolume <= 0) return mid();
+    // Each price is weighted by the opposite side's size: a heavy bid pulls towards the ask
+    return (static_cast<double>(bids.bestPrice()) * askVolume + static_cast<double>(asks.bestPrice()) * bidVolume)
+         / (bidVolume + askVolume);
+}
+
+double OrderBook::weightedMid(size_t levels) const {
+    if (bids.empty() || asks.empty() || levels == 0) return -1;
+    TopDepth bid = topDepth(Side::Bid, levels);
+    TopDepth ask = topDepth(Side::Ask, levels);
+    if (bid.volume == 0 || ask.volume == 0) return mid();
+    double bidVolume = static_cast<double>(bid.volume);
+    double askVolume = static_cast<double>(ask.volume);
+    return (bid.notional / bidVolume * askVolume + ask.notional / askVolume * bidVolume) / (bidVolume + askVolume);
+}
+
+double OrderBook::imbalance(size_t levels) const {
+    double bidVolume = static_cast<double>(topDepth(Side::Bid, levels).volume);
+    double askVolume = static_cast<double>(topDepth(Side::Ask, levels).volume);
+    return bidVolume + askVolume > 0 ? (bidVolume - askVolume) / (bidVolume + askVolume) : 0;
+}
+
+double OrderBook::spreadBps() const {
+    double mid = this->mid();
+    if (mid <= 0) return -1;
+    return static_cast<double>(asks.bestPrice() - bids.bestPrice()) / mid * 10000.0;
+}
+
+// Volume and notional of a side's best levels from the depth tree, finishing
+// behind the window only when the window holds fewer than levels levels
+OrderBook::TopDepth OrderBook::topDepth(Side side, size_t levels) const {
+    const Ladder& ladder = side == Side::Bid ? bids : asks;
+    TopDepthMemo& memo = side == Side::Bid ? bidTop : askTop;
+    if (memo.version == ladder.version() && memo.levels == levels) return memo.top;
+
+    DepthTree::Prefix prefix = depthTree(side).first(levels);
+
+    TopDepth top{prefix.volume, static_cast<double>(ladder.slotPrice(0)) * static_cast<double>(prefix.volume)
+                                + (side == Side::Bid ? -1.0 : 1.0) * static_cast<double>(prefix.weighted)};
+    size_t remaining = levels - prefix.levels;
+    if (remaining > 0) {
+        ladder.forEachOverflow([&top, &remaining](Price price, const PriceLevel& level) {
+            if (remaining == 0 || level.volume == 0) return;
+            top.volume += level.volume;
+            top.notional += static_cast<double>(price) * static_cast<double>(level.volume);
+            --remaining;
+        });
     }
-    return allAsks;
+    memo = {ladder.version(), levels, top};
+    return top;
 }
 
+const DepthTree& OrderBook::depthTree(Side side) const {
+    const Ladder& ladder = side == Side::Bid ? bids : asks;
+    DepthTree& tree = side == Side::Bid ? bidTree : askTree;
+    if (tree.layout == ladder.layout()) return tree;
+
+    tree.reset(ladder.windowSize());
+    ladder.forEach([&ladder, &tree](Price price, const PriceLevel& level) {
+        size_t slot = ladder.slotOf(price);
+        if (slot < ladder.windowSize()) tree.seed(slot, level.volume);
+    });
+    tree.finish();
+    tree.layout = ladder.layout();
+    return tree;
+}
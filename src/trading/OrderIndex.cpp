@@ -0,0 +1,87 @@
+#include "trading/OrderIndex.h"
+#include <algorithm>
+
+namespace {
+
+const size_t INITIAL_BUCKETS = 64;
+
+// splitmix64 finaliser: exchange and sequential ids both spread evenly
+std::uint64_t mix(std::uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+} // namespace
+
+OrderIndex::OrderIndex(std::pmr::memory_resource* resource)
+    : entries(INITIAL_BUCKETS, resource), mask(INITIAL_BUCKETS - 1) {}
+
+OrderIndex::OrderIndex(const OrderIndex& other, std::pmr::memory_resource* resource)
+    : entries(other.entries, resource), mask(other.mask), count(other.count) {}
+
+size_t OrderIndex::home(OrderId id) const {
+    return static_cast<size_t>(mix(id)) & mask;
+}
+
+std::uint32_t OrderIndex::find(OrderId id) const {
+    for (size_t i = home(id);; i = (i + 1) & mask) {
+        const Entry& entry = entries[i];
+        if (entry.slot == NONE) return NONE;
+        if (entry.id == id) return entry.slot;
+    }
+}
+
+bool OrderIndex::insert(OrderId id, std::uint32_t slot) {
+    if ((count + 1) * 2 > entries.size()) grow(); // keep load under 1/2
+
+    size_t i = home(id);
+    for (; entries[i].slot != NONE; i = (i + 1) & mask) {
+        if (entries[i].id == id) return false;
+    }
+    entries[i] = {id, slot};
+    ++count;
+    return true;
+}
+
+bool OrderIndex::erase(OrderId id) {
+    size_t i = home(id);
+    for (; entries[i].slot != NONE; i = (i + 1) & mask) {
+        if (entries[i].id == id) break;
+    }
+    if (entries[i].slot == NONE) return false;
+
+    // Shift later members of the probe run back so no gap breaks a lookup
+    size_t hole = i;
+    for (size_t j = (i + 1) & mask; entries[j].slot != NONE; j = (j + 1) & mask) {
+        size_t want = home(entries[j].id);
+        bool movable = hole <= j ? (want <= hole || want > j) : (want <= hole && want > j);
+        if (movable) {
+            entries[hole] = entries[j];
+            hole = j;
+        }
+    }
+    entries[hole] = Entry();
+    --count;
+    return true;
+}
+
+void OrderIndex::clear() {
+    std::fill(entries.begin(), entries.end(), Entry());
+    count = 0;
+}
+
+void OrderIndex::grow() {
+    std::pmr::vector<Entry> old(entries.size() * 2, entries.get_allocator());
+    old.swap(entries);
+    mask = entries.size() - 1;
+    for (const Entry& entry : old) {
+        if (entry.slot == NONE) continue;
+        size_t i = home(entry.id);
+        while (entries[i].slot != NONE) i = (i + 1) & mask;
+        entries[i] = entry;
+    }
+}
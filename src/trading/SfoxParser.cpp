@@ -0,0 +1,225 @@
+#include "trading/SfoxParser.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+
+namespace {
+
+// Cursor over a JSON text. Each read skips leading whitespace and fails
+// rather than throws on malformed input.
+class Reader {
+public:
+    explicit Reader(std::string_view text) : pos(text.data()), end(text.data() + text.size()) {}
+
+    // The next significant character without consuming it, '\0' at the end
+    char peek() {
+        skipSpace();
+        return pos < end ? *pos : '\0';
+    }
+
+    bool consume(char c) {
+        if (peek() != c) return false;
+        ++pos;
+        return true;
+    }
+
+    bool atEnd() {
+        skipSpace();
+        return pos == end;
+    }
+
+    // Contents between the quotes, escapes left as sent
+    bool string(std::string_view& out) {
+        if (!consume('"')) return false;
+        const char* start = pos;
+        for (; pos < end; ++pos) {
+            if (*pos == '\\') {
+                ++pos;
+            } else if (*pos == '"') {
+                out = std::string_view(start, pos - start);
+                ++pos;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool number(double& out) {
+        std::string_view token = numberToken();
+        auto result = std::from_chars(token.data(), token.data() + token.size(), out);
+        return !token.empty() && result.ec == std::errc() && result.ptr == token.data() + token.size();
+    }
+
+    // Fractional or out of range numbers are truncated through double
+    bool integer(std::int64_t& out) {
+        std::string_view token = numberToken();
+        if (token.empty()) return false;
+        auto result = std::from_chars(token.data(), token.data() + token.size(), out);
+        if (result.ec == std::errc() && result.ptr == token.data() + token.size()) return true;
+
+        double value;
+        result = std::from_chars(token.data(), token.data() + token.size(), value);
+        if (result.ec != std::errc() || result.ptr != token.data() + token.size()) return false;
+        out = static_cast<std::int64_t>(value);
+        return true;
+    }
+
+    // Calls onMember(key) with the cursor on each member's value; onMember must consume it
+    template <typename OnMember>
+    bool object(OnMember&& onMember) {
+        if (!consume('{')) return false;
+        if (consume('}')) return true;
+        do {
+            std::string_view key;
+            if (!string(key) || !consume(':') || !onMember(key)) return false;
+        } while (consume(','));
+        return consume('}');
+    }
+
+    // Calls onElement(index) with the cursor on each element; onElement must consume it
+    template <typename OnElement>
+    bool array(OnElement&& onElement) {
+        if (!consume('[')) return false;
+        if (consume(']')) return true;
+        size_t index = 0;
+        do {
+            if (!onElement(index++)) return false;
+        } while (consume(','));
+        return consume(']');
+    }
+
+    bool skipValue() {
+        char c = peek();
+        if (c == '"') {
+            std::string_view ignored;
+            return string(ignored);
+        }
+        if (c == '{' || c == '[') {
+            size_t depth = 0;
+            while (pos < end) {
+                if (*pos == '"') {
+                    std::string_view ignored;
+                    if (!string(ignored)) return false;
+                    continue;
+                }
+                char ch = *pos++;
+                if (ch == '{' || ch == '[') {
+                    ++depth;
+                } else if ((ch == '}' || ch == ']') && --depth == 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        // A number, true, false or null
+        const char* start = pos;
+        while (pos < end && (std::isalnum(static_cast<unsigned char>(*pos)) || *pos == '-' || *pos == '+' || *pos == '.')) {
+            ++pos;
+        }
+        return pos != start;
+    }
+
+private:
+    void skipSpace() {
+        while (pos < end && (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t')) ++pos;
+    }
+
+    std::string_view numberToken() {
+        skipSpace();
+        const char* start = pos;
+        while (pos < end && ((*pos >= '0' && *pos <= '9') || *pos == '-' || *pos == '+' || *pos == '.' ||
+                             *pos == 'e' || *pos == 'E')) {
+            ++pos;
+        }
+        return std::string_view(start, pos - start);
+    }
+
+    const char* pos;
+    const char* end;
+};
+
+bool isNumberStart(char c) {
+    return c == '-' || (c >= '0' && c <= '9');
+}
+
+// [[price, size, ...], ...]; entries with fewer than two fields are dropped
+bool readLevels(Reader& reader, std::vector<FeedLevel>& levels) {
+    levels.clear();
+    if (reader.peek() != '[') return reader.skipValue();
+    return reader.array([&](size_t) {
+        if (reader.peek() != '[') return reader.skipValue();
+        FeedLevel level{0, 0};
+        size_t fields = 0;
+        bool ok = reader.array([&](size_t index) {
+            fields = index + 1;
+            if (index == 0) return reader.number(level.price);
+            if (index == 1) return reader.number(level.size);
+            return reader.skipValue();
+        });
+        if (ok && fields >= 2) levels.push_back(level);
+        return ok;
+    });
+}
+
+template <typename Better>
+void keepBest(std::vector<Order>& levels, size_t depth, Better better) {
+    if (levels.size() > depth) {
+        std::nth_element(levels.begin(), levels.begin() + depth, levels.end(), better);
+        levels.erase(levels.begin() + depth, levels.end());
+    }
+    std::sort(levels.begin(), levels.end(), better);
+}
+
+} // namespace
+
+bool SfoxParser::parse(std::string_view payload, SfoxMessage& message) {
+    message.type = {};
+    message.recipient = {};
+    message.timestamp = 0;
+    message.hasBids = false;
+    message.hasAsks = false;
+    message.bids.clear();
+    message.asks.clear();
+
+    Reader reader(payload);
+    bool ok = reader.object([&](std::string_view key) {
+        if (key == "type" || key == "recipient") {
+            if (reader.peek() != '"') return reader.skipValue();
+            return reader.string(key == "type" ? message.type : message.recipient);
+        }
+        if (key == "timestamp") {
+            if (!isNumberStart(reader.peek())) return reader.skipValue();
+            return reader.integer(message.timestamp);
+        }
+        if (key == "payload") {
+            if (reader.peek() != '{') return reader.skipValue();
+            return reader.object([&](std::string_view field) {
+                if (field == "bids") {
+                    message.hasBids = true;
+                    return readLevels(reader, message.bids);
+                }
+                if (field == "asks") {
+                    message.hasAsks = true;
+                    return readLevels(reader, message.asks);
+                }
+                return reader.skipValue();
+            });
+        }
+        return reader.skipValue();
+    });
+    return ok && reader.atEnd();
+}
+
+void selectTopLevels(const std::vector<FeedLevel>& levels, Side side, const InstrumentSpec& spec, size_t depth,
+                     std::vector<Order>& out) {
+    out.clear();
+    for (const FeedLevel& level : levels) {
+        out.emplace_back(spec.toTicks(level.price), spec.toLots(level.size));
+    }
+    if (side == Side::Bid) {
+        keepBest(out, depth, [](const Order& a, const Order& b) { return a.price > b.price; });
+    } else {
+        keepBest(out, depth, [](const Order& a, const Order& b) { return a.price < b.price; });
+    }
+}